@@ -4,25 +4,100 @@
 
 #include "BgeEmbedderONNXRuntime.h"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 BgeEmbedderONNXRuntime::BgeEmbedderONNXRuntime(
     const std::string &modelPath,
     int intraThreads,
     int interThreads
-): env_(ORT_LOGGING_LEVEL_ERROR, "BgeEmbedderONNXRuntime") {
-    sessionOptions_.SetIntraOpNumThreads(intraThreads);
-    sessionOptions_.SetInterOpNumThreads(interThreads);
+): BgeEmbedderONNXRuntime(Config{"default", modelPath, ExecutionProvider::Cpu, intraThreads, interThreads}) {}
+
+BgeEmbedderONNXRuntime::BgeEmbedderONNXRuntime(const Config &config)
+    : config_(config), env_(ORT_LOGGING_LEVEL_ERROR, "BgeEmbedderONNXRuntime") {
+    sessionOptions_.SetIntraOpNumThreads(config_.intraThreads);
+    sessionOptions_.SetInterOpNumThreads(config_.interThreads);
     sessionOptions_.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+    appendExecutionProvider();
 
     // TODO: Download the model from HF
     embedder_ = std::make_unique<Ort::Session>(
         env_,
-        modelPath.c_str(),
+        config_.modelPath.c_str(),
         sessionOptions_
     );
 }
 
+void BgeEmbedderONNXRuntime::appendExecutionProvider() {
+    if (config_.provider != ExecutionProvider::Cpu && !isAvailable(config_.provider)) {
+        throw std::runtime_error("BgeEmbedderONNXRuntime: execution provider not available: " +
+                                 providerName(config_.provider));
+    }
+
+    switch (config_.provider) {
+        case ExecutionProvider::Cpu:
+            break;
+        case ExecutionProvider::Xnnpack:
+            // XNNPACK runs its own thread pool; ORT's would only spin next to it
+            sessionOptions_.SetIntraOpNumThreads(1);
+            sessionOptions_.AddConfigEntry("session.intra_op.allow_spinning", "0");
+            sessionOptions_.AppendExecutionProvider("XNNPACK", {
+                                                        {"intra_op_num_threads", std::to_string(config_.intraThreads)}
+                                                    });
+            break;
+        case ExecutionProvider::Dnnl: {
+            const OrtApi &api = Ort::GetApi();
+            OrtDnnlProviderOptions *dnnlOptions = nullptr;
+            Ort::ThrowOnError(api.CreateDnnlProviderOptions(&dnnlOptions));
+            OrtStatus *status = api.SessionOptionsAppendExecutionProvider_Dnnl(sessionOptions_, dnnlOptions);
+            api.ReleaseDnnlProviderOptions(dnnlOptions);
+            Ort::ThrowOnError(status);
+            break;
+        }
+        case ExecutionProvider::OpenVino:
+            sessionOptions_.AppendExecutionProvider_OpenVINO_V2({
+                {"device_type", "CPU"},
+                {"num_of_threads", std::to_string(config_.intraThreads)}
+            });
+            break;
+    }
+}
+
+bool BgeEmbedderONNXRuntime::isAvailable(const ExecutionProvider provider) {
+    std::string ortName;
+    switch (provider) {
+        case ExecutionProvider::Cpu: ortName = "CPUExecutionProvider";
+            break;
+        case ExecutionProvider::Xnnpack: ortName = "XnnpackExecutionProvider";
+            break;
+        case ExecutionProvider::Dnnl: ortName = "DnnlExecutionProvider";
+            break;
+        case ExecutionProvider::OpenVino: ortName = "OpenVINOExecutionProvider";
+            break;
+    }
+    const std::vector<std::string> available = Ort::GetAvailableProviders();
+    return std::find(available.begin(), available.end(), ortName) != available.end();
+}
+
+std::string BgeEmbedderONNXRuntime::providerName(const ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Cpu: return "cpu";
+        case ExecutionProvider::Xnnpack: return "xnnpack";
+        case ExecutionProvider::Dnnl: return "dnnl";
+        case ExecutionProvider::OpenVino: return "openvino";
+    }
+    return "unknown";
+}
+
+BgeEmbedderONNXRuntime::ExecutionProvider BgeEmbedderONNXRuntime::parseProvider(const std::string &name) {
+    if (name == "cpu") return ExecutionProvider::Cpu;
+    if (name == "xnnpack") return ExecutionProvider::Xnnpack;
+    if (name == "dnnl" || name == "onednn") return ExecutionProvider::Dnnl;
+    if (name == "openvino") return ExecutionProvider::OpenVino;
+    throw std::invalid_argument("BgeEmbedderONNXRuntime: unknown execution provider: " + name);
+}
+
 
 std::vector<std::vector<float> > BgeEmbedderONNXRuntime::run(const BgeTokenizerSentencePiece::Encoded &encoded) const {
     // Prepare ONNX tensors
@@ -12,13 +12,41 @@
 
 class BgeEmbedderONNXRuntime {
 public:
+    enum class ExecutionProvider {
+        Cpu, // ONNX Runtime's default CPU provider
+        Xnnpack,
+        Dnnl, // oneDNN
+        OpenVino
+    };
+
+    // One way of running the model: which file (fp32, int8, ...) on which execution provider
+    struct Config {
+        std::string name;
+        std::string modelPath;
+        ExecutionProvider provider{ExecutionProvider::Cpu};
+        int intraThreads{1};
+        int interThreads{1};
+    };
+
     BgeEmbedderONNXRuntime(
         const std::string &modelPath,
         int intraThreads,
         int interThreads
     );
+
+    explicit BgeEmbedderONNXRuntime(const Config &config);
+
     [[nodiscard]] std::vector<std::vector<float>> run(const BgeTokenizerSentencePiece::Encoded &encoded) const;
 
+    [[nodiscard]] const Config &config() const { return config_; }
+
+    // Whether the linked ONNX Runtime build ships the provider
+    static bool isAvailable(ExecutionProvider provider);
+
+    // Short names ("cpu", "xnnpack", "dnnl", "openvino") used on the command line and in tuning caches
+    static std::string providerName(ExecutionProvider provider);
+    static ExecutionProvider parseProvider(const std::string &name);
+
 private:
     std::vector<std::vector<float> > meanPool(
         const float *lastHiddenState,
@@ -28,7 +56,10 @@ private:
         const std::vector<int64_t> &attention_mask
     ) const;
 
+    void appendExecutionProvider();
+
     const float epsilon_{1e-9f};
+    Config config_;
     Ort::Env env_;
     Ort::SessionOptions sessionOptions_;
     std::unique_ptr<Ort::Session> embedder_;
@@ -0,0 +1,210 @@
+#include "EmbedderAutoTuner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <regex>
+#include <sstream>
+
+namespace {
+    // Callers make sure both vectors have the same dimension
+    float cosine(const std::vector<float> &a, const std::vector<float> &b) {
+        double dot = 0.0, na = 0.0, nb = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            dot += static_cast<double>(a[i]) * b[i];
+            na += static_cast<double>(a[i]) * a[i];
+            nb += static_cast<double>(b[i]) * b[i];
+        }
+        return static_cast<float>(dot / (std::sqrt(na * nb) + 1e-12));
+    }
+
+    std::uint64_t fnv1a(const std::string &s) {
+        std::uint64_t h = 1469598103934665603ull;
+        for (const unsigned char c: s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+EmbedderAutoTuner::EmbedderAutoTuner(
+    std::shared_ptr<BgeTokenizerSentencePiece> tokenizer,
+    Options options
+): tokenizer_(std::move(tokenizer)), options_(std::move(options)) {
+    if (options_.batchSize == 0) options_.batchSize = 1;
+    if (options_.repetitions == 0) options_.repetitions = 1;
+}
+
+EmbedderAutoTuner::Result EmbedderAutoTuner::select(
+    const std::vector<BgeEmbedderONNXRuntime::Config> &candidates,
+    const std::vector<std::string> &calibrationTexts,
+    std::vector<Result> *report
+) const {
+    if (candidates.empty()) throw std::invalid_argument("EmbedderAutoTuner: no candidates");
+    if (calibrationTexts.empty()) throw std::invalid_argument("EmbedderAutoTuner: empty calibration set");
+
+    const std::string key = fingerprint(candidates);
+    if (Result cached; !options_.cacheFile.empty() && loadCache(key, cached)) {
+        if (report) report->push_back(cached);
+        return cached;
+    }
+
+    // Tokenize once, every candidate sees exactly the same batches
+    std::vector<BgeTokenizerSentencePiece::Encoded> batches;
+    for (std::size_t i = 0; i < calibrationTexts.size(); i += options_.batchSize) {
+        const std::size_t end = std::min(calibrationTexts.size(), i + options_.batchSize);
+        batches.push_back(tokenizer_->encode({calibrationTexts.begin() + i, calibrationTexts.begin() + end}, true, true));
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::vector<std::vector<float>> reference;
+    Result best;
+    best.msPerText = std::numeric_limits<double>::infinity();
+
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        Result result;
+        result.config = candidates[c];
+        try {
+            if (!BgeEmbedderONNXRuntime::isAvailable(result.config.provider)) {
+                throw std::runtime_error("execution provider not available: " +
+                                         BgeEmbedderONNXRuntime::providerName(result.config.provider));
+            }
+            const BgeEmbedderONNXRuntime embedder(result.config);
+
+            // The untimed first pass warms up the session and yields the embeddings for the drift check
+            std::vector<std::vector<float>> embeddings;
+            embeddings.reserve(calibrationTexts.size());
+            for (const BgeTokenizerSentencePiece::Encoded &batch: batches) {
+                std::vector<std::vector<float>> out = embedder.run(batch);
+                std::move(out.begin(), out.end(), std::back_inserter(embeddings));
+            }
+
+            double bestMs = std::numeric_limits<double>::infinity();
+            for (std::size_t r = 0; r < options_.repetitions; ++r) {
+                const clock::time_point t0 = clock::now();
+                for (const BgeTokenizerSentencePiece::Encoded &batch: batches) {
+                    [[maybe_unused]] const std::vector<std::vector<float>> out = embedder.run(batch);
+                }
+                bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(clock::now() - t0).count());
+            }
+            result.msPerText = bestMs / static_cast<double>(calibrationTexts.size());
+
+            if (c == 0) {
+                reference = std::move(embeddings);
+            } else {
+                if (embeddings.size() != reference.size()) {
+                    throw std::runtime_error("returned " + std::to_string(embeddings.size()) + " embeddings, the reference " +
+                                             std::to_string(reference.size()));
+                }
+                for (std::size_t i = 0; i < reference.size(); ++i) {
+                    if (embeddings[i].size() != reference[i].size()) {
+                        throw std::runtime_error("embedding dimension " + std::to_string(embeddings[i].size()) +
+                                                 " differs from the reference " + std::to_string(reference[i].size()));
+                    }
+                    // NaN would slip through both std::max and the tolerance check, count it as unbounded drift
+                    const float drift = 1.0f - cosine(reference[i], embeddings[i]);
+                    result.maxDrift = std::isfinite(drift)
+                                          ? std::max(result.maxDrift, drift)
+                                          : std::numeric_limits<float>::infinity();
+                }
+            }
+            result.accepted = result.maxDrift <= options_.maxCosineDrift;
+        } catch (const std::exception &e) {
+            // Without the reference there is nothing to compare against
+            if (c == 0) throw;
+            result.error = e.what();
+        }
+
+        if (result.accepted && result.msPerText < best.msPerText) best = result;
+        if (report) report->push_back(result);
+    }
+
+    if (!options_.cacheFile.empty()) storeCache(key, best);
+    return best;
+}
+
+std::vector<std::string> EmbedderAutoTuner::loadCalibrationTexts(const std::string &chatsFile, const std::size_t n) {
+    std::ifstream file(chatsFile);
+    if (!file) throw std::runtime_error("EmbedderAutoTuner: cannot open " + chatsFile);
+
+    static const std::regex textRe(R"TXT("text"\s*:\s*"([^"]*)")TXT");
+    std::vector<std::string> texts;
+    std::string line;
+    while (texts.size() < n && std::getline(file, line)) {
+        std::string chat;
+        for (std::sregex_iterator it(line.begin(), line.end(), textRe); it != std::sregex_iterator(); ++it) {
+            chat += "\n" + (*it)[1].str();
+        }
+        if (!chat.empty()) texts.push_back(std::move(chat));
+    }
+    return texts;
+}
+
+std::string EmbedderAutoTuner::fingerprint(const std::vector<BgeEmbedderONNXRuntime::Config> &candidates) const {
+    // A new ONNX Runtime, a replaced model file or a changed candidate list invalidates the cached choice
+    std::ostringstream os;
+    os << Ort::GetVersionString() << '|' << options_.maxCosineDrift;
+    for (const BgeEmbedderONNXRuntime::Config &c: candidates) {
+        os << '|' << c.name << ';' << BgeEmbedderONNXRuntime::providerName(c.provider) << ';' << c.modelPath
+                << ';' << c.intraThreads << ';' << c.interThreads;
+        std::error_code ec;
+        const std::uintmax_t size = std::filesystem::file_size(c.modelPath, ec);
+        const auto mtime = std::filesystem::last_write_time(c.modelPath, ec);
+        os << ';' << size << ';' << mtime.time_since_epoch().count();
+    }
+    std::ostringstream hex;
+    hex << std::hex << fnv1a(os.str());
+    return hex.str();
+}
+
+bool EmbedderAutoTuner::loadCache(const std::string &expectedFingerprint, Result &result) const {
+    std::ifstream file(options_.cacheFile);
+    if (!file) return false;
+
+    std::map<std::string, std::string> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        const std::size_t eq = line.find('=');
+        if (eq != std::string::npos) values[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    if (values["fingerprint"] != expectedFingerprint) return false;
+
+    try {
+        result.config.name = values.at("name");
+        result.config.modelPath = values.at("modelPath");
+        result.config.provider = BgeEmbedderONNXRuntime::parseProvider(values.at("provider"));
+        result.config.intraThreads = std::stoi(values.at("intraThreads"));
+        result.config.interThreads = std::stoi(values.at("interThreads"));
+        result.msPerText = std::stod(values.at("msPerText"));
+        result.maxDrift = std::stof(values.at("maxDrift"));
+    } catch (const std::exception &) {
+        // Damaged cache, tune again
+        return false;
+    }
+    result.accepted = true;
+    result.fromCache = true;
+    return true;
+}
+
+void EmbedderAutoTuner::storeCache(const std::string &fingerprint, const Result &result) const {
+    std::ofstream file(options_.cacheFile, std::ios::trunc);
+    if (!file) {
+        std::cerr << "EmbedderAutoTuner: cannot write " << options_.cacheFile << '\n';
+        return;
+    }
+    file << "fingerprint=" << fingerprint << '\n'
+            << "name=" << result.config.name << '\n'
+            << "provider=" << BgeEmbedderONNXRuntime::providerName(result.config.provider) << '\n'
+            << "modelPath=" << result.config.modelPath << '\n'
+            << "intraThreads=" << result.config.intraThreads << '\n'
+            << "interThreads=" << result.config.interThreads << '\n'
+            << "msPerText=" << result.msPerText << '\n'
+            << "maxDrift=" << result.maxDrift << '\n';
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef EMBEDDERAUTOTUNER_H
+#define EMBEDDERAUTOTUNER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BgeEmbedderONNXRuntime.h"
+#include "BgeTokenizerSentencePiece.h"
+
+// Picks the fastest embedder configuration (execution provider x model precision) whose embeddings stay
+// close to a reference configuration, by timing every candidate on a small calibration set at startup.
+// The choice is written to a cache file and reused as long as the candidates and ONNX Runtime do not change.
+class EmbedderAutoTuner {
+public:
+    struct Options {
+        std::size_t batchSize{8};
+        std::size_t repetitions{3}; // Timed passes over the calibration set, the fastest one counts
+        float maxCosineDrift{0.02f}; // Worst-case 1 - cos(candidate, reference) over the calibration set
+        std::string cacheFile; // No caching when empty; VecSimServer uses <reference model>.tuning
+    };
+
+    struct Result {
+        BgeEmbedderONNXRuntime::Config config;
+        double msPerText{0.0};
+        float maxDrift{0.0f};
+        bool accepted{false};
+        bool fromCache{false};
+        std::string error; // Set when the candidate could not be loaded or run
+    };
+
+    EmbedderAutoTuner(
+        std::shared_ptr<BgeTokenizerSentencePiece> tokenizer,
+        Options options
+    );
+
+    // candidates.front() is the reference, typically the fp32 model on the default CPU provider, and is always
+    // acceptable. Candidates whose provider is missing from this ONNX Runtime build are skipped, candidates with
+    // non-finite drift or an embedding dimension other than the reference's are rejected.
+    // report, when given, receives one entry per candidate.
+    [[nodiscard]] Result select(
+        const std::vector<BgeEmbedderONNXRuntime::Config> &candidates,
+        const std::vector<std::string> &calibrationTexts,
+        std::vector<Result> *report = nullptr
+    ) const;
+
+    // Up to n chats from a chats.jsonl file, each flattened to its message texts the way the engine is queried
+    static std::vector<std::string> loadCalibrationTexts(const std::string &chatsFile, std::size_t n = 32);
+
+private:
+    [[nodiscard]] std::string fingerprint(const std::vector<BgeEmbedderONNXRuntime::Config> &candidates) const;
+    [[nodiscard]] bool loadCache(const std::string &expectedFingerprint, Result &result) const;
+    void storeCache(const std::string &fingerprint, const Result &result) const;
+
+    std::shared_ptr<BgeTokenizerSentencePiece> tokenizer_;
+    Options options_;
+};
+
+#endif //EMBEDDERAUTOTUNER_H
@@ -0,0 +1,199 @@
+#include "ServerProtocol.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    void putU8(std::string &out, const std::uint8_t v) {
+        out.push_back(static_cast<char>(v));
+    }
+
+    void putU32(std::string &out, const std::uint32_t v) {
+        const char bytes[4] = {
+            static_cast<char>(v & 0xFFu),
+            static_cast<char>((v >> 8) & 0xFFu),
+            static_cast<char>((v >> 16) & 0xFFu),
+            static_cast<char>((v >> 24) & 0xFFu)
+        };
+        out.append(bytes, 4);
+    }
+
+    void putF32(std::string &out, const float v) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        putU32(out, bits);
+    }
+
+    void putString(std::string &out, const std::string &s) {
+        putU32(out, static_cast<std::uint32_t>(s.size()));
+        out.append(s);
+    }
+
+    std::uint32_t readU32(const char *p) {
+        const auto *u = reinterpret_cast<const unsigned char *>(p);
+        return static_cast<std::uint32_t>(u[0]) |
+               static_cast<std::uint32_t>(u[1]) << 8 |
+               static_cast<std::uint32_t>(u[2]) << 16 |
+               static_cast<std::uint32_t>(u[3]) << 24;
+    }
+
+    // Bounds-checked cursor over a payload
+    class Reader {
+    public:
+        explicit Reader(const std::string_view payload): data_(payload) {}
+
+        std::uint8_t u8() {
+            need(1);
+            return static_cast<std::uint8_t>(data_[pos_++]);
+        }
+
+        std::uint32_t u32() {
+            need(4);
+            const std::uint32_t v = readU32(data_.data() + pos_);
+            pos_ += 4;
+            return v;
+        }
+
+        float f32() {
+            const std::uint32_t bits = u32();
+            float v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+
+        std::string string() {
+            const std::uint32_t len = u32();
+            need(len);
+            std::string s(data_.substr(pos_, len));
+            pos_ += len;
+            return s;
+        }
+
+        void finish() const {
+            if (pos_ != data_.size()) throw std::runtime_error("ServerProtocol: trailing bytes in payload");
+        }
+
+    private:
+        void need(const std::size_t n) const {
+            if (data_.size() - pos_ < n) throw std::runtime_error("ServerProtocol: truncated payload");
+        }
+
+        std::string_view data_;
+        std::size_t pos_{0};
+    };
+
+    // Reserves the length prefix and patches it once the payload is written
+    template<typename WritePayload>
+    void appendFrame(std::string &out, WritePayload &&write) {
+        const std::size_t start = out.size();
+        putU32(out, 0);
+        write(out);
+        const auto len = static_cast<std::uint32_t>(out.size() - start - ServerProtocol::headerSize);
+        std::string prefix;
+        putU32(prefix, len);
+        out.replace(start, ServerProtocol::headerSize, prefix);
+    }
+
+    ServerProtocol::Op toOp(const std::uint8_t v) {
+        if (v != static_cast<std::uint8_t>(ServerProtocol::Op::Embed) &&
+            v != static_cast<std::uint8_t>(ServerProtocol::Op::TopK)) {
+            throw std::runtime_error("ServerProtocol: unknown op " + std::to_string(v));
+        }
+        return static_cast<ServerProtocol::Op>(v);
+    }
+}
+
+void ServerProtocol::appendRequest(std::string &out, const Request &request) {
+    appendFrame(out, [&request](std::string &o) {
+        putU8(o, static_cast<std::uint8_t>(request.op));
+        putU32(o, request.id);
+        if (request.op == Op::TopK) {
+            putU32(o, request.k);
+            putString(o, request.filter);
+        }
+        putString(o, request.text);
+    });
+}
+
+void ServerProtocol::appendResponse(std::string &out, const Response &response) {
+    appendFrame(out, [&response](std::string &o) {
+        putU8(o, static_cast<std::uint8_t>(response.op));
+        putU32(o, response.id);
+        putU8(o, static_cast<std::uint8_t>(response.status));
+        if (response.status == Status::Error) {
+            putString(o, response.error);
+        } else if (response.op == Op::Embed) {
+            putU32(o, static_cast<std::uint32_t>(response.embedding.size()));
+            for (const float v: response.embedding) putF32(o, v);
+        } else {
+            putU32(o, static_cast<std::uint32_t>(response.skills.size()));
+            for (const auto &[skill, score]: response.skills) {
+                putString(o, skill);
+                putF32(o, score);
+            }
+        }
+    });
+}
+
+bool ServerProtocol::nextFrame(const std::string &buffer, std::size_t &offset, std::string_view &payload) {
+    if (buffer.size() - offset < headerSize) return false;
+    const std::uint32_t len = readU32(buffer.data() + offset);
+    if (len > maxFrameSize) {
+        throw std::runtime_error("ServerProtocol: frame of " + std::to_string(len) + " bytes exceeds limit");
+    }
+    if (buffer.size() - offset - headerSize < len) return false;
+    payload = std::string_view(buffer.data() + offset + headerSize, len);
+    offset += headerSize + len;
+    return true;
+}
+
+ServerProtocol::Request ServerProtocol::parseRequest(const std::string_view payload) {
+    Reader r(payload);
+    Request request;
+    request.op = toOp(r.u8());
+    request.id = r.u32();
+    if (request.op == Op::TopK) {
+        request.k = r.u32();
+        request.filter = r.string();
+    }
+    request.text = r.string();
+    r.finish();
+    // Filters are compiled per request on a worker, keep their cost bounded
+    if (request.filter.size() > maxFilterSize) {
+        throw RequestRejected(request.op, request.id, "ServerProtocol: filter of " +
+                              std::to_string(request.filter.size()) + " bytes exceeds limit");
+    }
+    return request;
+}
+
+ServerProtocol::Response ServerProtocol::parseResponse(const std::string_view payload) {
+    Reader r(payload);
+    Response response;
+    response.op = toOp(r.u8());
+    response.id = r.u32();
+    const std::uint8_t status = r.u8();
+    if (status > static_cast<std::uint8_t>(Status::Error)) {
+        throw std::runtime_error("ServerProtocol: unknown status " + std::to_string(status));
+    }
+    response.status = static_cast<Status>(status);
+    if (response.status == Status::Error) {
+        response.error = r.string();
+    } else if (response.op == Op::Embed) {
+        const std::uint32_t dim = r.u32();
+        // Each float needs 4 bytes, reject bogus counts before allocating
+        if (dim > payload.size() / 4) throw std::runtime_error("ServerProtocol: truncated payload");
+        response.embedding.reserve(dim);
+        for (std::uint32_t i = 0; i < dim; ++i) response.embedding.push_back(r.f32());
+    } else {
+        const std::uint32_t n = r.u32();
+        if (n > payload.size() / 8) throw std::runtime_error("ServerProtocol: truncated payload");
+        response.skills.reserve(n);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            std::string skill = r.string();
+            const float score = r.f32();
+            response.skills.emplace_back(std::move(skill), score);
+        }
+    }
+    r.finish();
+    return response;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#ifndef SERVERPROTOCOL_H
+#define SERVERPROTOCOL_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Length-prefixed binary protocol spoken by VecSimServer and VecSimLoadGen. All integers are little-endian,
+// floats are IEEE-754 binary32 sent as their bit pattern, strings are a u32 length followed by raw bytes.
+//
+//   frame    := u32 payloadLength, payload
+//   request  := u8 op, u32 requestId, body
+//     Embed  : string text
+//     TopK   : u32 k, string filter, string text
+//   response := u8 op, u32 requestId, u8 status, body
+//     Error  : string message
+//     Embed  : u32 dim, dim * f32
+//     TopK   : u32 n, n * (string skill, f32 score)
+class ServerProtocol {
+public:
+    typedef std::vector<std::pair<std::string, float>> SkillAndScoreVector;
+
+    enum class Op : std::uint8_t {
+        Embed = 1,
+        TopK = 2
+    };
+
+    enum class Status : std::uint8_t {
+        Ok = 0,
+        Error = 1
+    };
+
+    struct Request {
+        Op op{Op::Embed};
+        std::uint32_t id{0};
+        std::uint32_t k{0}; // TopK only, 0 lets the server pick its default
+        std::string filter; // TopK only, SkillFilter expression
+        std::string text;
+    };
+
+    struct Response {
+        Op op{Op::Embed};
+        std::uint32_t id{0};
+        Status status{Status::Ok};
+        std::string error;
+        std::vector<float> embedding;
+        SkillAndScoreVector skills;
+    };
+
+    // Frames larger than this are treated as a protocol violation
+    static constexpr std::uint32_t maxFrameSize = 16u << 20;
+    static constexpr std::size_t headerSize = 4;
+    // Longest filter expression a TopK request may carry
+    static constexpr std::size_t maxFilterSize = 4096;
+
+    // A well-formed request that is refused. The stream is still in sync, so the server answers it with an
+    // Error response instead of dropping the connection.
+    class RequestRejected : public std::runtime_error {
+    public:
+        RequestRejected(const Op op, const std::uint32_t id, const std::string &what)
+            : std::runtime_error(what), op(op), id(id) {}
+
+        Op op;
+        std::uint32_t id;
+    };
+
+    // Append a complete frame (length prefix included) to out
+    static void appendRequest(std::string &out, const Request &request);
+    static void appendResponse(std::string &out, const Response &response);
+
+    // If buffer holds a complete frame at offset, points payload at it, advances offset past it and returns true.
+    // Throws std::runtime_error when the announced length exceeds maxFrameSize.
+    static bool nextFrame(const std::string &buffer, std::size_t &offset, std::string_view &payload);
+
+    // Throw std::runtime_error on malformed payloads. parseRequest throws RequestRejected for a filter
+    // longer than maxFilterSize.
+    static Request parseRequest(std::string_view payload);
+    static Response parseResponse(std::string_view payload);
+};
+
+#endif //SERVERPROTOCOL_H
@@ -0,0 +1,149 @@
+#include "SkillFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+// Recursive-descent parser that evaluates the expression column-wise: every tag is a row bitset
+// and the operators combine whole 64-bit words, so evaluation never goes row by row.
+class SkillFilter::Parser {
+public:
+    Parser(
+        const SkillFilter &filter,
+        const std::string &expression
+    ): filter_(filter), expr_(expression), numWords_(numWords(filter.numRows_)) {}
+
+    Bitset parse() {
+        Bitset result = parseExpr();
+        skipSpaces();
+        if (pos_ != expr_.size()) fail("unexpected character");
+        return result;
+    }
+
+private:
+    Bitset parseExpr() {
+        Bitset lhs = parseTerm();
+        while (consume('|')) {
+            const Bitset rhs = parseTerm();
+            for (std::size_t w = 0; w < numWords_; ++w) lhs[w] |= rhs[w];
+        }
+        return lhs;
+    }
+
+    Bitset parseTerm() {
+        Bitset lhs = parseFactor();
+        while (consume('&')) {
+            const Bitset rhs = parseFactor();
+            for (std::size_t w = 0; w < numWords_; ++w) lhs[w] &= rhs[w];
+        }
+        return lhs;
+    }
+
+    Bitset parseFactor() {
+        // A run of '!' collapses to at most one inversion instead of one recursion per '!'
+        bool negate = false;
+        while (consume('!')) negate = !negate;
+
+        Bitset bits;
+        if (consume('(')) {
+            // Each '(' recurses through parseExpr, so expressions from clients must not nest without bound
+            if (++depth_ > maxDepth) fail("expression too deeply nested");
+            bits = parseExpr();
+            if (!consume(')')) fail("expected ')'");
+            --depth_;
+        } else {
+            bits = parseTag();
+        }
+
+        if (negate) {
+            for (std::size_t w = 0; w < numWords_; ++w) bits[w] = ~bits[w];
+            clearTail(bits);
+        }
+        return bits;
+    }
+
+    Bitset parseTag() {
+        skipSpaces();
+        const std::size_t start = pos_;
+        while (pos_ < expr_.size() && isTagChar(expr_[pos_])) ++pos_;
+        if (pos_ == start) fail("expected tag");
+
+        const auto it = filter_.tagRows_.find(expr_.substr(start, pos_ - start));
+        if (it == filter_.tagRows_.end()) return Bitset(numWords_, 0);
+
+        Bitset bits = it->second;
+        bits.resize(numWords_, 0);
+        return bits;
+    }
+
+    bool consume(const char c) {
+        skipSpaces();
+        if (pos_ < expr_.size() && expr_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void skipSpaces() {
+        while (pos_ < expr_.size() && std::isspace(static_cast<unsigned char>(expr_[pos_]))) ++pos_;
+    }
+
+    void clearTail(Bitset &bits) const {
+        if (const std::size_t rem = filter_.numRows_ % bitsPerWord; rem && !bits.empty()) {
+            bits.back() &= (std::uint64_t{1} << rem) - 1;
+        }
+    }
+
+    [[noreturn]] void fail(const std::string &what) const {
+        throw std::invalid_argument("SkillFilter: " + what + " at position " + std::to_string(pos_) +
+                                    " in \"" + expr_ + "\"");
+    }
+
+    const SkillFilter &filter_;
+    const std::string &expr_;
+    const std::size_t numWords_;
+    std::size_t pos_{0};
+    std::size_t depth_{0};
+};
+
+std::size_t SkillFilter::addSkill(const std::vector<std::string> &tags) {
+    for (const std::string &tag: tags) {
+        if (!isTag(tag)) throw std::invalid_argument("SkillFilter: invalid tag \"" + tag + "\"");
+    }
+
+    const std::size_t row = numRows_++;
+    for (const std::string &tag: tags) {
+        Bitset &bits = tagRows_[tag];
+        bits.resize(numWords(numRows_), 0);
+        bits[row / bitsPerWord] |= std::uint64_t{1} << (row % bitsPerWord);
+    }
+    return row;
+}
+
+SkillFilter::Bitset SkillFilter::compile(const std::string &expression) const {
+    if (expression.find_first_not_of(" \t\r\n") == std::string::npos) return all(numRows_);
+    return Parser(*this, expression).parse();
+}
+
+SkillFilter::Bitset SkillFilter::all(const std::size_t numRows) {
+    Bitset bits(numWords(numRows), ~std::uint64_t{0});
+    if (const std::size_t rem = numRows % bitsPerWord; rem) bits.back() = (std::uint64_t{1} << rem) - 1;
+    return bits;
+}
+
+std::size_t SkillFilter::count(const Bitset &bits) {
+    std::size_t n = 0;
+    for (std::uint64_t w: bits) {
+        for (; w; w &= w - 1) ++n;
+    }
+    return n;
+}
+
+bool SkillFilter::isTag(const std::string &tag) {
+    return !tag.empty() && std::all_of(tag.begin(), tag.end(), isTagChar);
+}
+
+bool SkillFilter::isTagChar(const char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == ':' || c == '.';
+}
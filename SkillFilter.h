@@ -0,0 +1,57 @@
+#pragma once
+#ifndef SKILLFILTER_H
+#define SKILLFILTER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Attribute tags for skills (tenant, language, category, ...) and boolean filter expressions over them.
+// Skills are added as rows and every distinct tag keeps a row bitset of the skills carrying it, so there is
+// no limit on the number of distinct tags and a tag costs one bit per skill.
+// A filter expression such as "team:billing & (lang:en | lang:de) & !deprecated" is compiled by combining
+// those bitsets into a Bitset with one bit per skill row, which the similarity scan consumes directly.
+class SkillFilter {
+public:
+    typedef std::vector<std::uint64_t> Bitset; // Bit i of word i / 64 is set when row i passes
+
+    static constexpr std::size_t bitsPerWord = 64;
+    static constexpr std::size_t maxDepth = 64; // Deepest parenthesis nesting compile() accepts
+
+    // Appends the next skill row with the given tags and returns its row index. Throws std::invalid_argument,
+    // without adding the row, when a tag is not isTag() and so could never be selected by an expression.
+    std::size_t addSkill(const std::vector<std::string> &tags);
+
+    // Compiles the expression into a bitset over all rows. Grammar, loosest binding first:
+    //   expr := term ('|' term)*,  term := factor ('&' factor)*,  factor := '!' factor | '(' expr ')' | tag
+    // Unknown tags match no row. An empty expression matches every row. Throws std::invalid_argument
+    // on syntax errors and on parentheses nested deeper than maxDepth.
+    [[nodiscard]] Bitset compile(const std::string &expression) const;
+
+    [[nodiscard]] std::size_t numRows() const { return numRows_; }
+    [[nodiscard]] std::size_t numTags() const { return tagRows_.size(); }
+
+    static std::size_t numWords(const std::size_t numRows) { return (numRows + bitsPerWord - 1) / bitsPerWord; }
+
+    static Bitset all(std::size_t numRows);
+
+    static bool test(const Bitset &bits, std::size_t row) {
+        return (bits[row / bitsPerWord] >> (row % bitsPerWord)) & 1u;
+    }
+
+    static std::size_t count(const Bitset &bits);
+
+    // Tags are non-empty runs of letters, digits and "_-:."
+    static bool isTag(const std::string &tag);
+    static bool isTagChar(char c);
+
+private:
+    class Parser;
+
+    // Bitsets only grow up to the last row carrying the tag; compile() pads them to numRows_
+    std::unordered_map<std::string, Bitset> tagRows_;
+    std::size_t numRows_{0};
+};
+
+#endif //SKILLFILTER_H
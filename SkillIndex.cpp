@@ -0,0 +1,48 @@
+#include "SkillIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "VectorSimilarityEngine.h"
+
+SkillIndex::SkillIndex(
+    std::vector<std::string> skillsPool,
+    std::vector<std::vector<float>> skillsEmbeddings,
+    std::vector<float> skillsNorms,
+    const std::vector<std::vector<std::string>> &skillsTags
+): skillsPool_(std::move(skillsPool)), skillsEmbeddings_(std::move(skillsEmbeddings)),
+   skillsNorms_(std::move(skillsNorms)) {
+    const std::size_t n = skillsPool_.size();
+    if (skillsEmbeddings_.size() != n || skillsNorms_.size() != n || (!skillsTags.empty() && skillsTags.size() != n)) {
+        throw std::invalid_argument("SkillIndex: skills, embeddings, norms and tags must have matching sizes");
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        filter_.addSkill(skillsTags.empty() ? std::vector<std::string>{} : skillsTags[i]);
+    }
+}
+
+std::unique_ptr<const SkillIndex> SkillIndex::build(
+    const VectorSimilarityEngine &engine,
+    std::vector<std::string> skillsPool,
+    const std::vector<std::vector<std::string>> &skillsTags
+) {
+    // An empty catalog is valid, but there is nothing to run through the model
+    if (skillsPool.empty()) {
+        return std::make_unique<const SkillIndex>(
+            std::vector<std::string>{}, std::vector<std::vector<float>>{}, std::vector<float>{}, skillsTags);
+    }
+
+    // One call for the whole pool would build a [N, maxLen] tensor, and this runs beside live traffic on reload
+    std::vector<std::vector<float>> skillsEmbeddings;
+    skillsEmbeddings.reserve(skillsPool.size());
+    for (std::size_t i = 0; i < skillsPool.size(); i += buildBatchSize) {
+        const std::size_t end = std::min(skillsPool.size(), i + buildBatchSize);
+        std::vector<std::vector<float>> chunk =
+                engine.getEmbeddings({skillsPool.begin() + i, skillsPool.begin() + end});
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(skillsEmbeddings));
+    }
+    std::vector<float> skillsNorms = engine.getNorms(skillsEmbeddings);
+    return std::make_unique<const SkillIndex>(
+        std::move(skillsPool), std::move(skillsEmbeddings), std::move(skillsNorms), skillsTags);
+}
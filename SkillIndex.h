@@ -0,0 +1,53 @@
+#pragma once
+#ifndef SKILLINDEX_H
+#define SKILLINDEX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SkillFilter.h"
+
+class VectorSimilarityEngine;
+
+// Everything a top-k query needs about one skill catalog: names, embeddings, norms and tags, kept together
+// so they can never disagree. Immutable after construction, which is what lets SkillIndexStore hand the
+// same instance to any number of concurrent readers.
+class SkillIndex {
+public:
+    // skillsTags may be empty or hold one tag list per skill
+    SkillIndex(
+        std::vector<std::string> skillsPool,
+        std::vector<std::vector<float>> skillsEmbeddings,
+        std::vector<float> skillsNorms,
+        const std::vector<std::vector<std::string>> &skillsTags
+    );
+
+    // Skills per model call in build(), bounding the input tensor and activations for large catalogs
+    static constexpr std::size_t buildBatchSize = 32;
+
+    // Embeds the pool with the engine, buildBatchSize skills at a time
+    static std::unique_ptr<const SkillIndex> build(
+        const VectorSimilarityEngine &engine,
+        std::vector<std::string> skillsPool,
+        const std::vector<std::vector<std::string>> &skillsTags = {}
+    );
+
+    [[nodiscard]] SkillFilter::Bitset compileFilter(const std::string &expression) const {
+        return filter_.compile(expression);
+    }
+
+    [[nodiscard]] std::size_t size() const { return skillsPool_.size(); }
+    [[nodiscard]] const std::vector<std::string> &skillsPool() const { return skillsPool_; }
+    [[nodiscard]] const std::vector<std::vector<float>> &skillsEmbeddings() const { return skillsEmbeddings_; }
+    [[nodiscard]] const std::vector<float> &skillsNorms() const { return skillsNorms_; }
+    [[nodiscard]] const SkillFilter &filter() const { return filter_; }
+
+private:
+    std::vector<std::string> skillsPool_;
+    std::vector<std::vector<float>> skillsEmbeddings_;
+    std::vector<float> skillsNorms_;
+    SkillFilter filter_;
+};
+
+#endif //SKILLINDEX_H
@@ -0,0 +1,149 @@
+#include "SkillIndexStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+// Why a reader can never use a freed snapshot (all operations below are seq_cst):
+// a reader announces epoch a, then loads current_. A writer exchanges current_, then bumps epoch_ to T and
+// tags the old snapshot with T. If the reader loaded the old pointer, its load preceded the exchange, so it
+// read epoch_ before the bump (a < T) and announced a before the writer scans the slots; the snapshot is only
+// freed once no announced epoch is below T. A reader announcing after the scan loads current_ after the
+// exchange and can only see newer snapshots.
+
+SkillIndexStore::ReadGuard::ReadGuard(ReadGuard &&other) noexcept
+    : slot_(other.slot_), index_(other.index_), version_(other.version_) {
+    other.slot_ = nullptr;
+}
+
+SkillIndexStore::ReadGuard::~ReadGuard() {
+    if (slot_) slot_->store(freeSlot, std::memory_order_release);
+}
+
+SkillIndexStore::SkillIndexStore(std::unique_ptr<const SkillIndex> initial): current_(nullptr) {
+    if (!initial) throw std::invalid_argument("SkillIndexStore: initial index is null");
+    current_.store(new Snapshot{std::move(initial), 1});
+    builder_ = std::thread(&SkillIndexStore::builderLoop, this);
+}
+
+SkillIndexStore::~SkillIndexStore() {
+    {
+        std::lock_guard<std::mutex> lock(builderMutex_);
+        stopping_ = true;
+    }
+    builderCv_.notify_all();
+    builder_.join();
+
+    for (const Retired &r: retired_) delete r.snapshot;
+    delete current_.load();
+}
+
+SkillIndexStore::ReadGuard SkillIndexStore::acquire() const {
+    // Start where this thread found a free slot last time, so an uncontended reader claims on the first try
+    thread_local std::size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id()) % maxReaders;
+
+    std::size_t i = hint;
+    for (std::size_t tries = 1;; ++tries, i = (i + 1) % maxReaders) {
+        std::uint64_t expected = freeSlot;
+        if (slots_[i].epoch.compare_exchange_strong(expected, claimedSlot)) break;
+        if (tries % maxReaders == 0) std::this_thread::yield();
+    }
+    hint = i;
+
+    std::atomic<std::uint64_t> &slot = slots_[i].epoch;
+    slot.store(epoch_.load());
+    const Snapshot *snapshot = current_.load();
+    return ReadGuard(&slot, snapshot->index.get(), snapshot->version);
+}
+
+void SkillIndexStore::publish(std::unique_ptr<const SkillIndex> next) {
+    if (!next) throw std::invalid_argument("SkillIndexStore: cannot publish a null index");
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        // Only writers touch current_'s version and they are serialised here
+        const Snapshot *replacement = new Snapshot{std::move(next), current_.load()->version + 1};
+        const Snapshot *old = current_.exchange(replacement);
+        const std::uint64_t retireEpoch = epoch_.fetch_add(1) + 1;
+        retired_.push_back({old, retireEpoch});
+        reclaim();
+    }
+
+    // Let the background thread free whatever is still pinned once its readers drain
+    {
+        std::lock_guard<std::mutex> lock(builderMutex_);
+    }
+    builderCv_.notify_all();
+}
+
+void SkillIndexStore::publishAsync(Builder builder) {
+    {
+        std::lock_guard<std::mutex> lock(builderMutex_);
+        pending_.push_back(std::move(builder));
+    }
+    builderCv_.notify_all();
+}
+
+void SkillIndexStore::waitIdle() {
+    std::unique_lock<std::mutex> lock(builderMutex_);
+    builderCv_.wait(lock, [this] { return pending_.empty() && !building_ && retiredCount_.load() == 0; });
+}
+
+std::uint64_t SkillIndexStore::version() const {
+    return acquire().version();
+}
+
+std::size_t SkillIndexStore::retiredCount() const {
+    return retiredCount_.load();
+}
+
+void SkillIndexStore::reclaim() {
+    std::uint64_t oldestPinned = std::numeric_limits<std::uint64_t>::max();
+    for (const Slot &slot: slots_) {
+        // A slot still being claimed has not loaded current_ yet, so it can only end up with a newer snapshot
+        if (const std::uint64_t e = slot.epoch.load(); e > claimedSlot) oldestPinned = std::min(oldestPinned, e);
+    }
+
+    const auto firstKept = std::partition(retired_.begin(), retired_.end(), [oldestPinned](const Retired &r) {
+        return r.epoch > oldestPinned;
+    });
+    for (auto it = firstKept; it != retired_.end(); ++it) delete it->snapshot;
+    retired_.erase(firstKept, retired_.end());
+    retiredCount_.store(retired_.size());
+}
+
+void SkillIndexStore::builderLoop() {
+    std::unique_lock<std::mutex> lock(builderMutex_);
+    while (!stopping_) {
+        if (!pending_.empty()) {
+            Builder builder = std::move(pending_.front());
+            pending_.pop_front();
+            building_ = true;
+            lock.unlock();
+
+            try {
+                publish(builder());
+            } catch (const std::exception &e) {
+                std::cerr << "SkillIndexStore: build failed, keeping version " << version() << ": " << e.what() << '\n';
+            }
+
+            lock.lock();
+            building_ = false;
+            continue;
+        }
+
+        if (retiredCount_.load() == 0) {
+            builderCv_.notify_all();
+            builderCv_.wait(lock, [this] { return stopping_ || !pending_.empty() || retiredCount_.load() > 0; });
+            continue;
+        }
+
+        // Readers never signal when they let go, so poll until the retired snapshots drain
+        {
+            std::lock_guard<std::mutex> writerLock(writerMutex_);
+            reclaim();
+        }
+        if (retiredCount_.load() > 0) builderCv_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
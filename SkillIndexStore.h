@@ -0,0 +1,117 @@
+#pragma once
+#ifndef SKILLINDEXSTORE_H
+#define SKILLINDEXSTORE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SkillIndex.h"
+
+// Publishes versioned SkillIndex snapshots through an atomic pointer so a catalog can be replaced under
+// live traffic. Readers pin the current snapshot with acquire(): no lock, no allocation, no reference
+// count, just an epoch announcement in a reader slot. Replaced snapshots are retired with the epoch of the
+// swap and freed (epoch-based reclamation) once every pinned reader started after that swap.
+class SkillIndexStore {
+public:
+    typedef std::function<std::unique_ptr<const SkillIndex>()> Builder;
+
+    // More concurrent readers than this wait for a slot to free up
+    static constexpr std::size_t maxReaders = 256;
+
+    // Keeps one snapshot pinned for its lifetime. Must not outlive the store.
+    class ReadGuard {
+    public:
+        ReadGuard(ReadGuard &&other) noexcept;
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+        ReadGuard &operator=(ReadGuard &&) = delete;
+        ~ReadGuard();
+
+        [[nodiscard]] const SkillIndex &operator*() const { return *index_; }
+        [[nodiscard]] const SkillIndex *operator->() const { return index_; }
+        [[nodiscard]] std::uint64_t version() const { return version_; }
+
+    private:
+        friend class SkillIndexStore;
+
+        ReadGuard(std::atomic<std::uint64_t> *slot, const SkillIndex *index, std::uint64_t version)
+            : slot_(slot), index_(index), version_(version) {}
+
+        std::atomic<std::uint64_t> *slot_;
+        const SkillIndex *index_;
+        std::uint64_t version_;
+    };
+
+    explicit SkillIndexStore(std::unique_ptr<const SkillIndex> initial);
+
+    // Joins the background builder. No ReadGuard may be alive anymore.
+    ~SkillIndexStore();
+
+    SkillIndexStore(const SkillIndexStore &) = delete;
+    SkillIndexStore &operator=(const SkillIndexStore &) = delete;
+
+    // Lock-free; never observes a partially built index
+    [[nodiscard]] ReadGuard acquire() const;
+
+    // Swaps in next as version() + 1 and frees whatever retired snapshots no reader can still see
+    void publish(std::unique_ptr<const SkillIndex> next);
+
+    // Runs builder on the background thread, publishes its result and waits there for the replaced snapshot
+    // to drain. Builds run one at a time in submission order; a builder that throws leaves the current
+    // snapshot in place.
+    void publishAsync(Builder builder);
+
+    // Blocks until every submitted build is published and every retired snapshot is freed
+    void waitIdle();
+
+    [[nodiscard]] std::uint64_t version() const;
+    [[nodiscard]] std::size_t retiredCount() const;
+
+private:
+    struct Snapshot {
+        std::unique_ptr<const SkillIndex> index;
+        std::uint64_t version;
+    };
+
+    struct Retired {
+        const Snapshot *snapshot;
+        std::uint64_t epoch;
+    };
+
+    // One cache line per slot so readers on different cores do not bounce each other's lines.
+    // epoch is 0 while the slot is free, 1 while it is being claimed and the announced epoch (> 1) while pinned.
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    static constexpr std::uint64_t freeSlot = 0;
+    static constexpr std::uint64_t claimedSlot = 1;
+
+    // Caller holds writerMutex_
+    void reclaim();
+    void builderLoop();
+
+    std::atomic<const Snapshot *> current_;
+    std::atomic<std::uint64_t> epoch_{claimedSlot + 1};
+    mutable Slot slots_[maxReaders];
+
+    mutable std::mutex writerMutex_;
+    std::vector<Retired> retired_;
+    std::atomic<std::size_t> retiredCount_{0};
+
+    std::mutex builderMutex_;
+    std::condition_variable builderCv_;
+    std::deque<Builder> pending_;
+    bool building_{false};
+    bool stopping_{false};
+    std::thread builder_;
+};
+
+#endif //SKILLINDEXSTORE_H
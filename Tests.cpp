@@ -2,9 +2,11 @@
 // Created by Mahrad Hosseini on 25.06.2025.
 //
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <regex>
+#include <thread>
 
 #include "Tests.h"
 
@@ -12,6 +14,10 @@
 
 #include "BgeEmbedderONNXRuntime.h"
 #include "BgeTokenizerSentencePiece.h"
+#include "EmbedderAutoTuner.h"
+#include "ServerProtocol.h"
+#include "SkillFilter.h"
+#include "SkillIndexStore.h"
 #include "VectorSimilarityEngine.h"
 
 // Testing BgeTokenizerSentencePiece
@@ -275,3 +281,284 @@ int TestVectorSimilarityEngine(
     std::cout << "Time Elapsed: " << ms << " ms\n";
     return 0;
 }
+
+// ----------------------------------------------------------------------------------------------------------------
+
+int TestSkillFilter() {
+    // 150 skills so the bitset spans three words, tagged by team, language and deprecation
+    // Each skill also gets one of 200 tenant tags, far more distinct tags than fit in a machine word
+    SkillFilter filter;
+    for (std::size_t i = 0; i < 150; ++i) {
+        std::vector<std::string> tags;
+        tags.emplace_back(i % 3 == 0 ? "team:billing" : "team:support");
+        tags.emplace_back(i % 2 == 0 ? "lang:en" : "lang:de");
+        if (i % 10 == 0) tags.emplace_back("deprecated");
+        tags.emplace_back("tenant:" + std::to_string(i % 200));
+        filter.addSkill(tags);
+    }
+
+    struct Case {
+        std::string expression;
+        bool (*expected)(std::size_t);
+    };
+    const std::vector<Case> cases = {
+        {"", [](std::size_t) { return true; }},
+        {"team:billing", [](std::size_t i) { return i % 3 == 0; }},
+        {"!team:billing", [](std::size_t i) { return i % 3 != 0; }},
+        {"team:billing & lang:en", [](std::size_t i) { return i % 6 == 0; }},
+        {"team:billing | lang:de", [](std::size_t i) { return i % 3 == 0 || i % 2 == 1; }},
+        {"team:support & !(lang:en | deprecated)", [](std::size_t i) { return i % 3 != 0 && i % 2 == 1; }},
+        {"lang:fr", [](std::size_t) { return false; }},
+        {"tenant:7 | tenant:149", [](std::size_t i) { return i == 7 || i == 149; }},
+    };
+
+    int failures = 0;
+    for (const Case &c: cases) {
+        const SkillFilter::Bitset bits = filter.compile(c.expression);
+        for (std::size_t i = 0; i < filter.numRows(); ++i) {
+            if (SkillFilter::test(bits, i) != c.expected(i)) {
+                std::cerr << "Mismatch for \"" << c.expression << "\" at row " << i << '\n';
+                ++failures;
+                break;
+            }
+        }
+        // Bits past the last row must stay clear, the scan relies on it
+        if (bits.size() != 3 || (bits.back() >> (filter.numRows() % SkillFilter::bitsPerWord)) != 0) {
+            std::cerr << "Bad tail for \"" << c.expression << "\"\n";
+            ++failures;
+        }
+    }
+
+    try {
+        (void) filter.compile("team:billing & (lang:en");
+        std::cerr << "Unbalanced parenthesis was accepted\n";
+        ++failures;
+    } catch (const std::invalid_argument &) {}
+
+    // Tags the grammar cannot spell are refused up front instead of becoming unselectable
+    try {
+        (void) filter.addSkill({"team:billing", "lang en"});
+        std::cerr << "Tag with a space was accepted\n";
+        ++failures;
+    } catch (const std::invalid_argument &) {}
+    if (filter.numRows() != 150) {
+        std::cerr << "Rejected skill was added anyway\n";
+        ++failures;
+    }
+
+    // Long '!' runs are fine, unbounded nesting is rejected instead of overflowing the stack
+    const SkillFilter::Bitset notNot = filter.compile(std::string(100001, '!') + "team:billing");
+    if (SkillFilter::test(notNot, 0) || !SkillFilter::test(notNot, 1)) {
+        std::cerr << "Odd '!' run did not invert\n";
+        ++failures;
+    }
+    try {
+        (void) filter.compile(std::string(100000, '(') + "lang:en" + std::string(100000, ')'));
+        std::cerr << "Too deeply nested expression was accepted\n";
+        ++failures;
+    } catch (const std::invalid_argument &) {}
+    const std::size_t depth = SkillFilter::maxDepth;
+    if (SkillFilter::count(filter.compile(std::string(depth, '(') + "lang:en" + std::string(depth, ')'))) != 75) {
+        std::cerr << "Nesting at maxDepth was rejected or miscompiled\n";
+        ++failures;
+    }
+
+    std::cout << "SkillFilter failures: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------------------------------------------
+
+int TestServerProtocol() {
+    int failures = 0;
+    auto check = [&failures](const bool ok, const char *what) {
+        if (!ok) {
+            std::cerr << "ServerProtocol: " << what << " failed\n";
+            ++failures;
+        }
+    };
+
+    // Two requests in one buffer, the second one split across reads
+    ServerProtocol::Request embed;
+    embed.op = ServerProtocol::Op::Embed;
+    embed.id = 7;
+    embed.text = "Network Issues";
+    ServerProtocol::Request topK;
+    topK.op = ServerProtocol::Op::TopK;
+    topK.id = 0xDEADBEEF;
+    topK.k = 3;
+    topK.filter = "team:billing & !deprecated";
+    topK.text = std::string("binary \0 safe", 13);
+
+    std::string wire;
+    ServerProtocol::appendRequest(wire, embed);
+    ServerProtocol::appendRequest(wire, topK);
+    std::string buffer = wire.substr(0, wire.size() - 5);
+
+    std::size_t offset = 0;
+    std::string_view payload;
+    check(ServerProtocol::nextFrame(buffer, offset, payload), "first frame");
+    const ServerProtocol::Request embedBack = ServerProtocol::parseRequest(payload);
+    check(embedBack.op == embed.op && embedBack.id == embed.id && embedBack.text == embed.text, "embed round trip");
+    check(!ServerProtocol::nextFrame(buffer, offset, payload), "partial frame");
+    buffer = wire;
+    check(ServerProtocol::nextFrame(buffer, offset, payload), "second frame");
+    const ServerProtocol::Request topKBack = ServerProtocol::parseRequest(payload);
+    check(topKBack.op == topK.op && topKBack.id == topK.id && topKBack.k == topK.k &&
+          topKBack.filter == topK.filter && topKBack.text == topK.text, "topk round trip");
+    check(offset == wire.size(), "offset after last frame");
+
+    ServerProtocol::Response response;
+    response.op = ServerProtocol::Op::TopK;
+    response.id = 42;
+    response.skills = {{"Billing Issues", 0.75f}, {"Payment Issues", -0.125f}};
+    wire.clear();
+    ServerProtocol::appendResponse(wire, response);
+    offset = 0;
+    check(ServerProtocol::nextFrame(wire, offset, payload), "response frame");
+    const ServerProtocol::Response responseBack = ServerProtocol::parseResponse(payload);
+    check(responseBack.id == 42 && responseBack.skills == response.skills, "response round trip");
+
+    // Truncated payloads and oversized frames are rejected
+    try {
+        (void) ServerProtocol::parseResponse(payload.substr(0, payload.size() - 1));
+        check(false, "truncated payload rejection");
+    } catch (const std::runtime_error &) {}
+    const std::string huge("\xFF\xFF\xFF\xFF", 4);
+    try {
+        offset = 0;
+        (void) ServerProtocol::nextFrame(huge, offset, payload);
+        check(false, "oversized frame rejection");
+    } catch (const std::runtime_error &) {}
+
+    // An overlong filter is refused with the request's id so the server can answer it
+    ServerProtocol::Request longFilter = topK;
+    longFilter.filter.assign(ServerProtocol::maxFilterSize + 1, 'x');
+    wire.clear();
+    ServerProtocol::appendRequest(wire, longFilter);
+    offset = 0;
+    check(ServerProtocol::nextFrame(wire, offset, payload), "long filter frame");
+    try {
+        (void) ServerProtocol::parseRequest(payload);
+        check(false, "long filter rejection");
+    } catch (const ServerProtocol::RequestRejected &e) {
+        check(e.op == topK.op && e.id == topK.id, "long filter rejection id");
+    }
+
+    std::cout << "ServerProtocol failures: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------------------------------------------
+
+int TestEmbedderAutoTuner(
+    const std::string &onnxFile,
+    const std::string &tokenizerFile,
+    const std::string &chatsFile
+) {
+    using clock = std::chrono::steady_clock;
+    const clock::time_point t0 = clock::now();
+
+    try {
+        // Same model on every provider, plus more threads on the default one
+        typedef BgeEmbedderONNXRuntime::ExecutionProvider EP;
+        const std::vector<BgeEmbedderONNXRuntime::Config> candidates = {
+            {"cpu", onnxFile, EP::Cpu, 1, 1},
+            {"cpu-4t", onnxFile, EP::Cpu, 4, 1},
+            {"xnnpack", onnxFile, EP::Xnnpack, 4, 1},
+            {"dnnl", onnxFile, EP::Dnnl, 4, 1},
+            {"openvino", onnxFile, EP::OpenVino, 4, 1}
+        };
+        const EmbedderAutoTuner tuner(std::make_shared<BgeTokenizerSentencePiece>(tokenizerFile),
+                                      EmbedderAutoTuner::Options{});
+        std::vector<EmbedderAutoTuner::Result> report;
+        const EmbedderAutoTuner::Result chosen =
+                tuner.select(candidates, EmbedderAutoTuner::loadCalibrationTexts(chatsFile, 16), &report);
+
+        for (const EmbedderAutoTuner::Result &r: report) {
+            std::cout << r.config.name << ": ";
+            if (!r.error.empty()) std::cout << "skipped (" << r.error << ")\n";
+            else std::cout << r.msPerText << " ms/text, max drift " << r.maxDrift << (r.accepted ? "" : " rejected") << '\n';
+        }
+        std::cout << "Chosen: " << chosen.config.name << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    const clock::time_point t1 = clock::now();
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+    std::cout << "Time Elapsed: " << ms << " ms\n";
+    return 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------------
+
+// Catalog whose every field encodes its version, so a reader can tell a torn or freed snapshot apart
+static std::unique_ptr<const SkillIndex> makeVersionedIndex(const std::size_t version) {
+    const std::size_t n = 1 + version % 50;
+    std::vector<std::string> skillsPool(n, "skill v" + std::to_string(version));
+    std::vector<std::vector<float>> skillsEmbeddings(n, std::vector<float>(4, static_cast<float>(version)));
+    std::vector<float> skillsNorms(n, static_cast<float>(version) * 2.0f);
+    return std::make_unique<const SkillIndex>(std::move(skillsPool), std::move(skillsEmbeddings),
+                                              std::move(skillsNorms), std::vector<std::vector<std::string>>{});
+}
+
+int TestSkillIndexStore(const std::size_t readers, const std::size_t versions) {
+    using clock = std::chrono::steady_clock;
+    const clock::time_point t0 = clock::now();
+
+    SkillIndexStore store(makeVersionedIndex(1));
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> failures{0};
+    std::atomic<std::size_t> reads{0};
+
+    std::vector<std::thread> threads;
+    for (std::size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            std::uint64_t lastVersion = 0;
+            while (!done.load()) {
+                const SkillIndexStore::ReadGuard index = store.acquire();
+                const std::size_t v = index.version();
+                const std::string expected = "skill v" + std::to_string(v);
+                bool ok = v >= lastVersion && index->size() == 1 + v % 50;
+                for (std::size_t i = 0; ok && i < index->size(); ++i) {
+                    ok = index->skillsPool()[i] == expected &&
+                         index->skillsEmbeddings()[i][3] == static_cast<float>(v) &&
+                         index->skillsNorms()[i] == static_cast<float>(v) * 2.0f;
+                }
+                if (!ok) ++failures;
+                lastVersion = v;
+                ++reads;
+            }
+        });
+    }
+
+    // Half the versions are published synchronously, half through the background builder
+    for (std::size_t v = 2; v <= versions; ++v) {
+        if (v % 2) store.publishAsync([v] { return makeVersionedIndex(v); });
+        else {
+            store.waitIdle();
+            store.publish(makeVersionedIndex(v));
+        }
+    }
+    store.waitIdle();
+    done.store(true);
+    for (std::thread &t: threads) t.join();
+    store.waitIdle();
+
+    if (store.version() != versions) {
+        std::cerr << "Final version " << store.version() << ", expected " << versions << '\n';
+        ++failures;
+    }
+    if (store.retiredCount() != 0) {
+        std::cerr << store.retiredCount() << " retired snapshot(s) never freed\n";
+        ++failures;
+    }
+
+    const clock::time_point t1 = clock::now();
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+    std::cout << "SkillIndexStore reads: " << reads.load() << ", failures: " << failures.load() << std::endl;
+    std::cout << "Time Elapsed: " << ms << " ms\n";
+    return failures.load() == 0 ? 0 : 1;
+}
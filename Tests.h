@@ -37,6 +37,18 @@ int TestVectorSimilarityEngine(
     const std::string &chatsFile
     );
 
+int TestEmbedderAutoTuner(
+    const std::string &onnxFile,
+    const std::string &tokenizerFile,
+    const std::string &chatsFile
+    );
+
+int TestSkillFilter();
+
+int TestServerProtocol();
+
+int TestSkillIndexStore(std::size_t readers = 8, std::size_t versions = 200);
+
 void printChats(const std::vector<std::string> &chats);
 static Chat parseChatLine(const std::string &line);
 
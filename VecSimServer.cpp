@@ -0,0 +1,655 @@
+#include "VecSimServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/event.h>
+#else
+#error "VecSimServer needs epoll or kqueue"
+#endif
+
+namespace {
+#ifdef MSG_NOSIGNAL
+    constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int sendFlags = 0; // SO_NOSIGPIPE is set per socket instead
+#endif
+
+    [[noreturn]] void throwErrno(const std::string &what) {
+        throw std::system_error(errno, std::generic_category(), "VecSimServer: " + what);
+    }
+
+    void setNonBlocking(const int fd) {
+        const int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) throwErrno("fcntl");
+    }
+
+    // Missing files compare unequal to any real modification time, so they are retried
+    std::filesystem::file_time_type lastWriteTime(const std::string &file) {
+        std::error_code ec;
+        const std::filesystem::file_time_type mtime = std::filesystem::last_write_time(file, ec);
+        return ec ? std::filesystem::file_time_type::min() : mtime;
+    }
+
+    std::unique_ptr<const SkillIndex> loadIndex(const VectorSimilarityEngine &engine, const std::string &skillsFile) {
+        std::vector<std::string> skillsPool;
+        std::vector<std::vector<std::string>> skillsTags;
+        VecSimServer::loadSkills(skillsFile, skillsPool, skillsTags);
+        return SkillIndex::build(engine, std::move(skillsPool), skillsTags);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------------
+
+// Level-triggered readiness notification over epoll or kqueue
+class VecSimServer::Poller {
+public:
+    struct Event {
+        int fd;
+        bool readable;
+        bool writable;
+        bool error;
+    };
+
+    Poller() {
+#if defined(__linux__)
+        fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+#else
+        fd_ = ::kqueue();
+#endif
+        if (fd_ < 0) throwErrno("cannot create poller");
+    }
+
+    ~Poller() { ::close(fd_); }
+
+    Poller(const Poller &) = delete;
+    Poller &operator=(const Poller &) = delete;
+
+    void add(const int fd) {
+#if defined(__linux__)
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (::epoll_ctl(fd_, EPOLL_CTL_ADD, fd, &ev) < 0) throwErrno("epoll_ctl add");
+#else
+        change(fd, EVFILT_READ, EV_ADD);
+        // Registered disabled so update() only ever has to toggle it
+        change(fd, EVFILT_WRITE, EV_ADD | EV_DISABLE);
+#endif
+    }
+
+    void update(const int fd, const bool wantRead, const bool wantWrite) {
+#if defined(__linux__)
+        epoll_event ev{};
+        ev.events = (wantRead ? EPOLLIN : 0u) | (wantWrite ? EPOLLOUT : 0u);
+        ev.data.fd = fd;
+        if (::epoll_ctl(fd_, EPOLL_CTL_MOD, fd, &ev) < 0) throwErrno("epoll_ctl mod");
+#else
+        change(fd, EVFILT_READ, wantRead ? EV_ENABLE : EV_DISABLE);
+        change(fd, EVFILT_WRITE, wantWrite ? EV_ENABLE : EV_DISABLE);
+#endif
+    }
+
+    void remove(const int fd) {
+#if defined(__linux__)
+        ::epoll_ctl(fd_, EPOLL_CTL_DEL, fd, nullptr);
+#else
+        // Closing the descriptor drops its filters, nothing to do
+        (void) fd;
+#endif
+    }
+
+    void wait(std::vector<Event> &events, const int timeoutMs) {
+        events.clear();
+#if defined(__linux__)
+        epoll_event ready[256];
+        const int n = ::epoll_wait(fd_, ready, 256, timeoutMs);
+        if (n < 0) {
+            if (errno == EINTR) return;
+            throwErrno("epoll_wait");
+        }
+        for (int i = 0; i < n; ++i) {
+            const std::uint32_t e = ready[i].events;
+            events.push_back({
+                ready[i].data.fd,
+                (e & (EPOLLIN | EPOLLHUP)) != 0,
+                (e & EPOLLOUT) != 0,
+                (e & EPOLLERR) != 0
+            });
+        }
+#else
+        struct kevent ready[256];
+        timespec ts{timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+        const int n = ::kevent(fd_, nullptr, 0, ready, 256, timeoutMs < 0 ? nullptr : &ts);
+        if (n < 0) {
+            if (errno == EINTR) return;
+            throwErrno("kevent");
+        }
+        for (int i = 0; i < n; ++i) {
+            events.push_back({
+                static_cast<int>(ready[i].ident),
+                ready[i].filter == EVFILT_READ,
+                ready[i].filter == EVFILT_WRITE,
+                (ready[i].flags & EV_ERROR) != 0
+            });
+        }
+#endif
+    }
+
+private:
+#if !defined(__linux__)
+    void change(const int fd, const short filter, const unsigned short flags) {
+        struct kevent kev{};
+        EV_SET(&kev, fd, filter, flags, 0, 0, nullptr);
+        if (::kevent(fd_, &kev, 1, nullptr, 0, nullptr) < 0) throwErrno("kevent change");
+    }
+#endif
+
+    int fd_{-1};
+};
+
+// ----------------------------------------------------------------------------------------------------------------
+
+VecSimServer::VecSimServer(
+    std::shared_ptr<VectorSimilarityEngine> engine,
+    std::string skillsFile,
+    Options options
+): engine_(std::move(engine)), skillsFile_(std::move(skillsFile)), options_(std::move(options)),
+   // Taken before loading, so an edit made during the initial build is seen as a change afterwards
+   skillsFileTime_(lastWriteTime(skillsFile_)),
+   index_(loadIndex(*engine_, skillsFile_)), poller_(std::make_unique<Poller>()) {
+    options_.maxBatch = std::max<std::size_t>(options_.maxBatch, 1);
+    options_.numWorkers = std::max<std::size_t>(options_.numWorkers, 1);
+
+    nextReloadCheck_ = clock::now() + options_.reloadCheckInterval;
+
+    if (::pipe(wakeFds_) < 0) throwErrno("pipe");
+    setNonBlocking(wakeFds_[0]);
+    setNonBlocking(wakeFds_[1]);
+}
+
+VecSimServer::~VecSimServer() {
+    stop();
+    for (std::thread &t: workers_) {
+        if (t.joinable()) t.join();
+    }
+    for (const int fd: wakeFds_) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+void VecSimServer::stop() {
+    stopping_.store(true);
+    // Only async-signal-safe calls here, the event loop wakes the workers on its way out
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t n = ::write(wakeFds_[1], &byte, 1);
+}
+
+void VecSimServer::requestReload() {
+    reloadRequested_.store(true);
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t n = ::write(wakeFds_[1], &byte, 1);
+}
+
+void VecSimServer::run() {
+    listenFd_ = openListener();
+    poller_->add(listenFd_);
+    poller_->add(wakeFds_[0]);
+
+    for (std::size_t i = 0; i < options_.numWorkers; ++i) {
+        workers_.emplace_back(&VecSimServer::workerLoop, this);
+    }
+
+    const bool watchSkillsFile = options_.reloadCheckInterval.count() > 0;
+    std::vector<Poller::Event> events;
+    while (!stopping_.load()) {
+        poller_->wait(events, watchSkillsFile ? static_cast<int>(options_.reloadCheckInterval.count()) : -1);
+        for (const Poller::Event &ev: events) {
+            if (ev.fd == listenFd_) {
+                acceptConnections();
+                continue;
+            }
+            if (ev.fd == wakeFds_[0]) {
+                char drain[256];
+                while (::read(wakeFds_[0], drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+
+            const auto it = connectionByFd_.find(ev.fd);
+            if (it == connectionByFd_.end()) continue;
+            const std::uint64_t id = it->second;
+            Connection &c = connections_.at(id);
+            bool alive = !ev.error;
+            if (alive && ev.readable) alive = readFrom(id, c);
+            if (alive && ev.writable) alive = flush(c);
+            if (!alive) closeConnection(id);
+        }
+        drainCompletions();
+
+        if (reloadRequested_.exchange(false)) {
+            checkSkillsFile(true);
+        } else if (watchSkillsFile && clock::now() >= nextReloadCheck_) {
+            checkSkillsFile(false);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.clear();
+    }
+    queueCv_.notify_all();
+    for (std::thread &t: workers_) t.join();
+    workers_.clear();
+
+    while (!connections_.empty()) closeConnection(connections_.begin()->first);
+    ::close(listenFd_);
+    listenFd_ = -1;
+    if (!options_.unixSocketPath.empty()) ::unlink(options_.unixSocketPath.c_str());
+}
+
+int VecSimServer::openListener() const {
+    int fd;
+    if (!options_.unixSocketPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (options_.unixSocketPath.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("VecSimServer: socket path too long: " + options_.unixSocketPath);
+        }
+        std::strncpy(addr.sun_path, options_.unixSocketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) throwErrno("socket");
+        // A stale socket file from a previous run would make bind fail, but never delete anything else
+        struct stat st{};
+        if (::lstat(options_.unixSocketPath.c_str(), &st) == 0) {
+            if (!S_ISSOCK(st.st_mode)) {
+                ::close(fd);
+                throw std::invalid_argument("VecSimServer: refusing to replace non-socket " + options_.unixSocketPath);
+            }
+            ::unlink(options_.unixSocketPath.c_str());
+        }
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            throwErrno("bind " + options_.unixSocketPath);
+        }
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(options_.port);
+        if (::inet_pton(AF_INET, options_.host.c_str(), &addr.sin_addr) != 1) {
+            throw std::invalid_argument("VecSimServer: invalid IPv4 address: " + options_.host);
+        }
+        if (!options_.allowNonLoopback && (ntohl(addr.sin_addr.s_addr) >> 24) != 127) {
+            throw std::invalid_argument("VecSimServer: refusing to listen on non-loopback address " + options_.host +
+                                        " without allowNonLoopback");
+        }
+
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) throwErrno("socket");
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            throwErrno("bind " + options_.host + ":" + std::to_string(options_.port));
+        }
+    }
+
+    if (::listen(fd, SOMAXCONN) < 0) {
+        ::close(fd);
+        throwErrno("listen");
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+void VecSimServer::acceptConnections() {
+    while (true) {
+        const int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN means the backlog is drained; anything else is per-connection and not fatal for the listener
+            if (errno != EAGAIN && errno != EWOULDBLOCK) std::cerr << "VecSimServer: accept: " << std::strerror(errno) << '\n';
+            return;
+        }
+        setNonBlocking(fd);
+        const int one = 1;
+        if (options_.unixSocketPath.empty()) ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+        const std::uint64_t id = nextConnectionId_++;
+        Connection &c = connections_[id];
+        c.fd = fd;
+        connectionByFd_[fd] = id;
+        poller_->add(fd);
+    }
+}
+
+bool VecSimServer::readFrom(const std::uint64_t connectionId, Connection &connection) {
+    // Read interest is off after EOF, so another readiness report means the peer hung up completely
+    if (connection.readClosed) return false;
+
+    char buf[64 * 1024];
+    // Bounded per wakeup so one fast sender cannot buffer without limit; level triggering brings us back
+    for (std::size_t total = 0; total < 16 * sizeof(buf);) {
+        const ssize_t n = ::read(connection.fd, buf, sizeof(buf));
+        if (n > 0) {
+            connection.in.append(buf, static_cast<std::size_t>(n));
+            total += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n == 0) {
+            // Half-close: requests already received still get their answers, see flush()
+            connection.readClosed = true;
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        return false;
+    }
+    return dispatchFrames(connectionId, connection);
+}
+
+bool VecSimServer::dispatchFrames(const std::uint64_t connectionId, Connection &connection) {
+    // Complete frames beyond the in-flight limit stay buffered until responses come back
+    std::vector<Job> jobs;
+    try {
+        std::string_view payload;
+        while (connection.inFlight < options_.maxInFlightPerConnection &&
+               ServerProtocol::nextFrame(connection.in, connection.inOffset, payload)) {
+            try {
+                jobs.push_back({connectionId, ServerProtocol::parseRequest(payload), clock::now()});
+                ++connection.inFlight;
+            } catch (const ServerProtocol::RequestRejected &e) {
+                // Answered right here, it never reaches the queue
+                ServerProtocol::Response response;
+                response.op = e.op;
+                response.id = e.id;
+                response.status = ServerProtocol::Status::Error;
+                response.error = e.what();
+                ServerProtocol::appendResponse(connection.out, response);
+            }
+        }
+    } catch (const std::exception &e) {
+        // The stream cannot be resynchronised after a bad frame
+        std::cerr << "VecSimServer: dropping connection: " << e.what() << '\n';
+        return false;
+    }
+
+    // Keep only the unconsumed tail of a partial frame
+    if (connection.inOffset == connection.in.size()) {
+        connection.in.clear();
+        connection.inOffset = 0;
+    } else if (connection.inOffset > 0) {
+        connection.in.erase(0, connection.inOffset);
+        connection.inOffset = 0;
+    }
+
+    if (!jobs.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            std::move(jobs.begin(), jobs.end(), std::back_inserter(queue_));
+        }
+        queueCv_.notify_all();
+    }
+    return flush(connection);
+}
+
+bool VecSimServer::flush(Connection &connection) {
+    while (connection.outOffset < connection.out.size()) {
+        const ssize_t n = ::send(connection.fd, connection.out.data() + connection.outOffset,
+                                 connection.out.size() - connection.outOffset, sendFlags);
+        if (n > 0) {
+            connection.outOffset += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    if (connection.outOffset == connection.out.size()) {
+        connection.out.clear();
+        connection.outOffset = 0;
+    }
+
+    updateInterest(connection);
+    // A half-closed connection is done once nothing is in flight and every answer is written
+    return !(connection.readClosed && connection.inFlight == 0 && connection.out.empty());
+}
+
+void VecSimServer::updateInterest(Connection &connection) {
+    // Only ask for writability while there is something left to send, and stop reading a client that is
+    // not keeping up so its requests pile up in its own socket buffer rather than in the queue
+    const bool wantWrite = !connection.out.empty();
+    const bool wantRead = !connection.readClosed && connection.inFlight < options_.maxInFlightPerConnection &&
+                          connection.out.size() - connection.outOffset < options_.maxPendingOutput;
+    if (wantRead != connection.wantRead || wantWrite != connection.wantWrite) {
+        poller_->update(connection.fd, wantRead, wantWrite);
+        connection.wantRead = wantRead;
+        connection.wantWrite = wantWrite;
+    }
+}
+
+void VecSimServer::closeConnection(const std::uint64_t connectionId) {
+    const auto it = connections_.find(connectionId);
+    if (it == connections_.end()) return;
+    poller_->remove(it->second.fd);
+    ::close(it->second.fd);
+    connectionByFd_.erase(it->second.fd);
+    connections_.erase(it);
+}
+
+void VecSimServer::drainCompletions() {
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        done.swap(completions_);
+    }
+
+    // Append everything first so each connection is flushed once per wakeup
+    std::vector<std::uint64_t> touched;
+    for (Completion &completion: done) {
+        const auto it = connections_.find(completion.connectionId);
+        // The client went away while its request was in flight
+        if (it == connections_.end()) continue;
+        touched.push_back(completion.connectionId);
+        it->second.out += completion.frame;
+        --it->second.inFlight;
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (const std::uint64_t id: touched) {
+        // Returned responses free in-flight slots for frames that were held back
+        const auto it = connections_.find(id);
+        if (it != connections_.end() && !dispatchFrames(id, it->second)) closeConnection(id);
+    }
+}
+
+void VecSimServer::checkSkillsFile(const bool force) {
+    nextReloadCheck_ = clock::now() + options_.reloadCheckInterval;
+
+    std::error_code ec;
+    const std::filesystem::file_time_type mtime = std::filesystem::last_write_time(skillsFile_, ec);
+    // A file being replaced may briefly be missing, try again next round
+    if (ec) return;
+    if (!force) {
+        // The running build decides what is loaded; a failed one leaves the old time behind and is retried here
+        if (reloadsInFlight_.load() > 0) return;
+        std::lock_guard<std::mutex> lock(skillsFileMutex_);
+        if (mtime == skillsFileTime_) return;
+    }
+
+    std::cout << "VecSimServer: reloading skills from " << skillsFile_ << std::endl;
+    ++reloadsInFlight_;
+    // The build embeds the new catalog on the store's background thread while the workers keep serving
+    index_.publishAsync([this, mtime] {
+        try {
+            std::unique_ptr<const SkillIndex> index = loadIndex(*engine_, skillsFile_);
+            {
+                std::lock_guard<std::mutex> lock(skillsFileMutex_);
+                skillsFileTime_ = mtime;
+            }
+            --reloadsInFlight_;
+            return index;
+        } catch (...) {
+            --reloadsInFlight_;
+            throw;
+        }
+    });
+}
+
+void VecSimServer::workerLoop() {
+    std::vector<Job> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return stopping_.load() || !queue_.empty(); });
+            if (stopping_.load()) return;
+
+            // Let concurrent requests join the batch until it is full or the oldest one has waited long enough
+            const clock::time_point deadline = queue_.front().enqueued + options_.maxBatchDelay;
+            queueCv_.wait_until(lock, deadline, [this] {
+                return stopping_.load() || queue_.empty() || queue_.size() >= options_.maxBatch;
+            });
+            if (stopping_.load()) return;
+
+            // Another worker may have taken everything meanwhile
+            const std::size_t n = std::min(queue_.size(), options_.maxBatch);
+            batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.begin() + n));
+            queue_.erase(queue_.begin(), queue_.begin() + n);
+        }
+        if (batch.empty()) continue;
+
+        processBatch(batch);
+        batch.clear();
+    }
+}
+
+void VecSimServer::processBatch(std::vector<Job> &batch) {
+    // The whole batch ranks against one snapshot, even if a new catalog is published meanwhile
+    const SkillIndexStore::ReadGuard index = index_.acquire();
+
+    std::vector<ServerProtocol::Response> responses(batch.size());
+    std::vector<SkillFilter::Bitset> filters(batch.size());
+    std::vector<std::size_t> toEmbed;
+    std::vector<std::string> texts;
+    toEmbed.reserve(batch.size());
+    texts.reserve(batch.size());
+
+    // Compile filters first so requests that match nothing, or fail to parse, never reach the model
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        ServerProtocol::Request &request = batch[i].request;
+        responses[i].op = request.op;
+        responses[i].id = request.id;
+        if (request.op == ServerProtocol::Op::TopK) {
+            try {
+                filters[i] = index->compileFilter(request.filter);
+            } catch (const std::exception &e) {
+                responses[i].status = ServerProtocol::Status::Error;
+                responses[i].error = e.what();
+                continue;
+            }
+            if (SkillFilter::count(filters[i]) == 0) continue;
+        }
+        toEmbed.push_back(i);
+        texts.push_back(std::move(request.text));
+    }
+
+    if (!texts.empty()) {
+        try {
+            std::vector<std::vector<float>> embeddings = engine_->getEmbeddings(texts);
+            for (std::size_t j = 0; j < toEmbed.size(); ++j) {
+                const std::size_t i = toEmbed[j];
+                const ServerProtocol::Request &request = batch[i].request;
+                if (request.op == ServerProtocol::Op::Embed) {
+                    responses[i].embedding = std::move(embeddings[j]);
+                    continue;
+                }
+                const std::size_t k = request.k ? request.k : options_.defaultK;
+                responses[i].skills = engine_->getTopSkillsForEmbedding(
+                    embeddings[j], index->skillsPool(), index->skillsEmbeddings(), index->skillsNorms(), filters[i], k);
+            }
+        } catch (const std::exception &e) {
+            for (const std::size_t i: toEmbed) {
+                responses[i].status = ServerProtocol::Status::Error;
+                responses[i].error = e.what();
+            }
+        }
+    }
+
+    std::vector<Completion> done;
+    done.reserve(batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        Completion completion{batch[i].connectionId, {}};
+        ServerProtocol::appendResponse(completion.frame, responses[i]);
+        done.push_back(std::move(completion));
+    }
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        std::move(done.begin(), done.end(), std::back_inserter(completions_));
+    }
+    // A full pipe already guarantees a pending wakeup
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t n = ::write(wakeFds_[1], &byte, 1);
+}
+
+void VecSimServer::loadSkills(
+    const std::string &skillsFile,
+    std::vector<std::string> &skillsPool,
+    std::vector<std::vector<std::string>> &skillsTags
+) {
+    std::ifstream file(skillsFile);
+    if (!file) throw std::runtime_error("VecSimServer: cannot open skills file: " + skillsFile);
+
+    skillsPool.clear();
+    skillsTags.clear();
+    std::string line;
+    std::size_t lineNo = 0;
+    while (std::getline(file, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line.front() == '#') continue;
+
+        const std::size_t tab = line.find('\t');
+        skillsPool.push_back(line.substr(0, tab));
+        std::vector<std::string> tags;
+        if (tab != std::string::npos) {
+            std::size_t start = tab + 1;
+            while (start <= line.size()) {
+                const std::size_t comma = std::min(line.find(',', start), line.size());
+                // "team:billing, lang:en" is common, the spaces are not part of the tag
+                const std::size_t first = line.find_first_not_of(" \t", start);
+                const std::size_t last = line.find_last_not_of(" \t", comma - 1);
+                if (first < comma && last != std::string::npos && last >= first) {
+                    std::string tag = line.substr(first, last - first + 1);
+                    // Anything the filter grammar cannot spell would be a tag no request can ever select
+                    if (!SkillFilter::isTag(tag)) {
+                        throw std::runtime_error("VecSimServer: invalid tag \"" + tag + "\" at " + skillsFile + ":" +
+                                                 std::to_string(lineNo));
+                    }
+                    tags.push_back(std::move(tag));
+                }
+                start = comma + 1;
+            }
+        }
+        skillsTags.push_back(std::move(tags));
+    }
+}
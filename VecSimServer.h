@@ -0,0 +1,152 @@
+#pragma once
+#ifndef VECSIMSERVER_H
+#define VECSIMSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ServerProtocol.h"
+#include "SkillIndexStore.h"
+#include "VectorSimilarityEngine.h"
+
+// Serves embed and top-k requests from one shared engine over a Unix domain socket or loopback TCP.
+// The protocol has no authentication, so TCP binds outside 127.0.0.0/8 need Options::allowNonLoopback.
+// A single non-blocking event loop (epoll on Linux, kqueue on macOS) owns every socket and only parses
+// and writes frames. Parsed requests go to a shared queue from which worker threads take up to maxBatch
+// requests, embed them with one model call, and hand encoded responses back to the loop through a pipe.
+// The skills file is watched; a changed catalog is built in the background and swapped in without pausing
+// queries, each batch ranks against the snapshot it pinned when it started. A failed build keeps the old
+// catalog and is retried on the next check.
+class VecSimServer {
+public:
+    struct Options {
+        std::string unixSocketPath; // Listen on this Unix domain socket when set, TCP otherwise
+        std::string host{"127.0.0.1"};
+        std::uint16_t port{7878};
+        bool allowNonLoopback{false}; // Permit a host outside 127.0.0.0/8, e.g. 0.0.0.0
+        std::size_t maxBatch{32};
+        std::chrono::microseconds maxBatchDelay{2000}; // How long the oldest queued request waits for company
+        std::size_t numWorkers{1};
+        std::size_t defaultK{5};
+        std::chrono::milliseconds reloadCheckInterval{5000}; // How often the skills file is checked, 0 disables
+        // Backpressure: a connection is not read from while it has this many requests queued or being
+        // processed, or this many response bytes its client has not taken yet
+        std::size_t maxInFlightPerConnection{64};
+        std::size_t maxPendingOutput{4u << 20};
+    };
+
+    // Loads and embeds the skills file (see loadSkills) before returning
+    VecSimServer(
+        std::shared_ptr<VectorSimilarityEngine> engine,
+        std::string skillsFile,
+        Options options
+    );
+
+    ~VecSimServer();
+
+    VecSimServer(const VecSimServer &) = delete;
+    VecSimServer &operator=(const VecSimServer &) = delete;
+
+    // Binds the listener and serves until stop() is called
+    void run();
+
+    // Safe to call from any thread and from signal handlers
+    void stop();
+
+    // Rebuilds the skill index from the skills file even if it looks unchanged. Signal-safe like stop().
+    void requestReload();
+
+    [[nodiscard]] std::size_t numSkills() const { return index_.acquire()->size(); }
+
+    // Reads a skills file: one skill per line, optionally followed by a tab and comma-separated tags.
+    // Blank lines and lines starting with '#' are skipped. There is no limit on the number of distinct tags.
+    // Spaces around tags are dropped; a tag SkillFilter::isTag() rejects throws with the file and line.
+    static void loadSkills(
+        const std::string &skillsFile,
+        std::vector<std::string> &skillsPool,
+        std::vector<std::vector<std::string>> &skillsTags
+    );
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct Connection {
+        int fd{-1};
+        std::string in;
+        std::size_t inOffset{0};
+        std::string out;
+        std::size_t outOffset{0};
+        std::size_t inFlight{0}; // Requests handed to the workers whose responses are not back yet
+        bool readClosed{false}; // The client shut down its side; closed once every answer is sent
+        bool wantRead{true};
+        bool wantWrite{false};
+    };
+
+    struct Job {
+        std::uint64_t connectionId;
+        ServerProtocol::Request request;
+        clock::time_point enqueued;
+    };
+
+    struct Completion {
+        std::uint64_t connectionId;
+        std::string frame;
+    };
+
+    class Poller;
+
+    int openListener() const;
+    void acceptConnections();
+    [[nodiscard]] bool readFrom(std::uint64_t connectionId, Connection &connection);
+    [[nodiscard]] bool dispatchFrames(std::uint64_t connectionId, Connection &connection);
+    [[nodiscard]] bool flush(Connection &connection);
+    void updateInterest(Connection &connection);
+    void closeConnection(std::uint64_t connectionId);
+    void drainCompletions();
+    void workerLoop();
+    void processBatch(std::vector<Job> &batch);
+    void checkSkillsFile(bool force);
+
+    // Members
+    std::shared_ptr<VectorSimilarityEngine> engine_;
+    std::string skillsFile_;
+    Options options_;
+    // Written by the store's build thread, so declared before index_ whose destructor joins it
+    std::mutex skillsFileMutex_;
+    std::filesystem::file_time_type skillsFileTime_; // Of the catalog last built successfully
+    std::atomic<std::size_t> reloadsInFlight_{0};
+    SkillIndexStore index_;
+    clock::time_point nextReloadCheck_;
+
+    std::unique_ptr<Poller> poller_;
+    int listenFd_{-1};
+    int wakeFds_[2]{-1, -1};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> reloadRequested_{false};
+
+    // Event loop thread only
+    std::unordered_map<std::uint64_t, Connection> connections_;
+    std::unordered_map<int, std::uint64_t> connectionByFd_;
+    std::uint64_t nextConnectionId_{1};
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<Job> queue_;
+
+    std::mutex completionMutex_;
+    std::vector<Completion> completions_;
+
+    std::vector<std::thread> workers_;
+};
+
+#endif //VECSIMSERVER_H
@@ -1,9 +1,23 @@
 //
 // Created by Mahrad Hosseini on 25.06.2025.
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <stdexcept>
 #include<numeric>
 #include "VectorSimilarityEngine.h"
+#include "SkillIndex.h"
+
+namespace {
+    void checkFilterSize(const SkillFilter::Bitset &filter, const std::size_t numSkills) {
+        if (filter.size() != SkillFilter::numWords(numSkills)) {
+            throw std::invalid_argument("VectorSimilarityEngine: filter covers " + std::to_string(filter.size()) +
+                                        " words but the skills pool needs " +
+                                        std::to_string(SkillFilter::numWords(numSkills)));
+        }
+    }
+}
 
 VectorSimilarityEngine::VectorSimilarityEngine(
     const std::string &tokenizerFilePath,
@@ -11,41 +25,90 @@ VectorSimilarityEngine::VectorSimilarityEngine(
 ): tokenizer_(std::make_shared<BgeTokenizerSentencePiece>(tokenizerFilePath, 512)),
    embedder_(std::make_shared<BgeEmbedderONNXRuntime>(embedderFilePath, 1, 1)){}
 
+VectorSimilarityEngine::VectorSimilarityEngine(
+    const std::string &tokenizerFilePath,
+    const BgeEmbedderONNXRuntime::Config &embedderConfig
+): tokenizer_(std::make_shared<BgeTokenizerSentencePiece>(tokenizerFilePath, 512)),
+   embedder_(std::make_shared<BgeEmbedderONNXRuntime>(embedderConfig)){}
+
 VectorSimilarityEngine::SkillAndScoreVector VectorSimilarityEngine::getTopSkills(
     const std::string &chat,
     const std::vector<std::string> &skillsPool,
     const std::vector<std::vector<float>> &skillsEmbeddings,
     const std::vector<float> &skillsNorms,
     const std::size_t k) const {
-    const std::vector<float> chatVec = getEmbedding(chat);
-    const float chatNorm = l2Norm(chatVec);
+    return getTopSkills(chat, skillsPool, skillsEmbeddings, skillsNorms, SkillFilter::all(skillsPool.size()), k);
+}
+
+VectorSimilarityEngine::SkillAndScoreVector VectorSimilarityEngine::getTopSkills(
+    const std::string &chat,
+    const std::vector<std::string> &skillsPool,
+    const std::vector<std::vector<float>> &skillsEmbeddings,
+    const std::vector<float> &skillsNorms,
+    const SkillFilter::Bitset &filter,
+    const std::size_t k) const {
+    checkFilterSize(filter, skillsPool.size());
 
-    // Cosine Similarity against every skill
+    // Nothing passes the filter, skip the embedding altogether
+    if (SkillFilter::count(filter) == 0) return {};
+
+    return getTopSkillsForEmbedding(getEmbedding(chat), skillsPool, skillsEmbeddings, skillsNorms, filter, k);
+}
+
+VectorSimilarityEngine::SkillAndScoreVector VectorSimilarityEngine::getTopSkills(
+    const std::string &chat,
+    const SkillIndex &index,
+    const std::string &filterExpression,
+    const std::size_t k) const {
+    return getTopSkills(chat, index.skillsPool(), index.skillsEmbeddings(), index.skillsNorms(),
+                        index.compileFilter(filterExpression), k);
+}
+
+VectorSimilarityEngine::SkillAndScoreVector VectorSimilarityEngine::getTopSkillsForEmbedding(
+    const std::vector<float> &chatVec,
+    const std::vector<std::string> &skillsPool,
+    const std::vector<std::vector<float>> &skillsEmbeddings,
+    const std::vector<float> &skillsNorms,
+    const SkillFilter::Bitset &filter,
+    const std::size_t k) const {
     const std::size_t numSkills = skillsPool.size();
-    std::vector<float> sims(numSkills);
-    for (std::size_t i = 0; i < numSkills; ++i) {
-        float dot = dotProduct(skillsEmbeddings[i], chatVec);
-        sims[i] = dot / ((skillsNorms[i] * chatNorm) + epsilon_);
+    checkFilterSize(filter, numSkills);
+
+    const std::size_t numPassing = SkillFilter::count(filter);
+    if (numPassing == 0) return {};
+
+    const float chatNorm = l2Norm(chatVec);
+
+    // Cosine Similarity against every skill that passes the filter, 64 rows per filter word. Scores live next to
+    // their row so the cost follows the number of passing skills, not the pool size.
+    std::vector<std::pair<std::size_t, float>> scored;
+    scored.reserve(numPassing);
+    for (std::size_t w = 0; w < filter.size(); ++w) {
+        std::uint64_t bits = filter[w];
+        // Whole block filtered out
+        if (!bits) continue;
+        const std::size_t base = w * SkillFilter::bitsPerWord;
+        for (; bits; bits &= bits - 1) {
+            const std::size_t i = base + static_cast<std::size_t>(__builtin_ctzll(bits));
+            float dot = dotProduct(skillsEmbeddings[i], chatVec);
+            scored.emplace_back(i, dot / ((skillsNorms[i] * chatNorm) + epsilon_));
+        }
     }
 
-    std::vector<std::size_t> idx(numSkills);
-    std::iota(idx.begin(), idx.end(), 0);
-    if (k < numSkills) {
-        std::partial_sort(idx.begin(), idx.begin() + k, idx.end(), [&sims](std::size_t a, std::size_t b) {
-            return sims[a] > sims[b];
-        });
-        idx.resize(k);
+    const auto byScore = [](const std::pair<std::size_t, float> &a, const std::pair<std::size_t, float> &b) {
+        return a.second > b.second;
+    };
+    if (k < scored.size()) {
+        std::partial_sort(scored.begin(), scored.begin() + k, scored.end(), byScore);
+        scored.resize(k);
     } else {
-        std::sort(idx.begin(), idx.end(), [&sims](std::size_t a, std::size_t b) {
-            return sims[a] > sims[b];
-        });
+        std::sort(scored.begin(), scored.end(), byScore);
     }
 
-    std::vector<std::string> topSkills;
-    std::vector<float> topScores;
     SkillAndScoreVector tops;
-    for (std::size_t i: idx) {
-        tops.emplace_back(skillsPool[i], sims[i]);
+    tops.reserve(scored.size());
+    for (const auto &[i, sim]: scored) {
+        tops.emplace_back(skillsPool[i], sim);
     }
     return tops;
 }
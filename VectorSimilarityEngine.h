@@ -10,6 +10,9 @@
 #include <onnxruntime_cxx_api.h>
 #include "BgeTokenizerSentencePiece.h"
 #include "BgeEmbedderONNXRuntime.h"
+#include "SkillFilter.h"
+
+class SkillIndex;
 
 class VectorSimilarityEngine {
 public:
@@ -21,6 +24,12 @@ public:
         const std::string &embedderFilePath
         );
 
+    // Runs the embedder with an explicit provider/model choice, e.g. the one picked by EmbedderAutoTuner
+    VectorSimilarityEngine(
+        const std::string &tokenizerFilePath,
+        const BgeEmbedderONNXRuntime::Config &embedderConfig
+        );
+
     [[nodiscard]] SkillAndScoreVector getTopSkills(
     const std::string &chat,
     const std::vector<std::string> &skillsPool,
@@ -28,6 +37,32 @@ public:
     const std::vector<float> &skillsNorms,
     std::size_t k = 5) const ;
 
+    // Top-k restricted to the rows set in filter (see SkillFilter::compile). Filtered-out rows are never scored.
+    // Throws std::invalid_argument when filter was not compiled for a pool of this size.
+    [[nodiscard]] SkillAndScoreVector getTopSkills(
+    const std::string &chat,
+    const std::vector<std::string> &skillsPool,
+    const std::vector<std::vector<float>> &skillsEmbeddings,
+    const std::vector<float> &skillsNorms,
+    const SkillFilter::Bitset &filter,
+    std::size_t k = 5) const ;
+
+    // Top-k against one SkillIndex snapshot, e.g. pinned through SkillIndexStore::acquire()
+    [[nodiscard]] SkillAndScoreVector getTopSkills(
+    const std::string &chat,
+    const SkillIndex &index,
+    const std::string &filterExpression = "",
+    std::size_t k = 5) const ;
+
+    // Same ranking for a chat that is already embedded, e.g. as part of a batched getEmbeddings call
+    [[nodiscard]] SkillAndScoreVector getTopSkillsForEmbedding(
+    const std::vector<float> &chatVec,
+    const std::vector<std::string> &skillsPool,
+    const std::vector<std::vector<float>> &skillsEmbeddings,
+    const std::vector<float> &skillsNorms,
+    const SkillFilter::Bitset &filter,
+    std::size_t k = 5) const ;
+
     // Multiple texts embedder
     [[nodiscard]] std::vector<std::vector<float> > getEmbeddings(const std::vector<std::string> &texts) const;
 
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ServerProtocol.h"
+
+// Closed-loop load generator for VecSimServer: every connection keeps exactly one request in flight,
+// so the server sees as many concurrent requests as there are connections.
+
+struct LoadGenOptions {
+    std::string unixSocketPath;
+    std::string host{"127.0.0.1"};
+    std::uint16_t port{7878};
+    std::size_t connections{8};
+    std::size_t requests{1000}; // Per connection
+    ServerProtocol::Op op{ServerProtocol::Op::TopK};
+    std::uint32_t k{5};
+    std::string filter;
+    std::string queriesFile;
+};
+
+static int connectTo(const LoadGenOptions &options) {
+    int fd;
+    if (!options.unixSocketPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, options.unixSocketPath.c_str(), sizeof(addr.sun_path) - 1);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+            throw std::runtime_error("cannot connect to " + options.unixSocketPath + ": " + std::strerror(errno));
+        }
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(options.port);
+        if (::inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1) {
+            throw std::runtime_error("invalid IPv4 address: " + options.host);
+        }
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+            throw std::runtime_error("cannot connect to " + options.host + ":" + std::to_string(options.port) +
+                                     ": " + std::strerror(errno));
+        }
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+#ifdef SO_NOSIGPIPE
+    const int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    return fd;
+}
+
+static void sendAll(const int fd, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + sent, data.size() - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw std::runtime_error(std::string("write: ") + std::strerror(errno));
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+static ServerProtocol::Response receiveResponse(const int fd, std::string &buffer) {
+    char chunk[64 * 1024];
+    while (true) {
+        std::size_t offset = 0;
+        std::string_view payload;
+        if (ServerProtocol::nextFrame(buffer, offset, payload)) {
+            ServerProtocol::Response response = ServerProtocol::parseResponse(payload);
+            buffer.erase(0, offset);
+            return response;
+        }
+        const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw std::runtime_error("connection closed by server");
+        buffer.append(chunk, static_cast<std::size_t>(n));
+    }
+}
+
+static std::vector<std::string> loadQueries(const std::string &queriesFile) {
+    if (queriesFile.empty()) {
+        return {
+            "My card was charged twice for the same subscription this month.",
+            "The database keeps timing out whenever we run the nightly report.",
+            "After the last OS update the laptop no longer boots.",
+            "Our AI assistant answers very slowly since yesterday.",
+            "I cannot connect to the VPN from the office network.",
+            "The printer on the third floor is jammed again.",
+            "We need to review the contract terms before renewal.",
+            "How do I cancel my plan and get a refund?"
+        };
+    }
+    std::ifstream file(queriesFile);
+    if (!file) throw std::runtime_error("cannot open " + queriesFile);
+    std::vector<std::string> queries;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) queries.push_back(line);
+    }
+    if (queries.empty()) throw std::runtime_error("no queries in " + queriesFile);
+    return queries;
+}
+
+static double percentile(const std::vector<double> &sorted, const double p) {
+    if (sorted.empty()) return 0.0;
+    // Nearest-rank
+    const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+static void printUsage(const char *argv0) {
+    std::cerr << "Usage: " << argv0 << " [--unix PATH | --host HOST --port N]\n"
+            << "         [--connections N] [--requests N] [--op embed|topk] [--k N] [--filter EXPR]\n"
+            << "         [--queries FILE]\n";
+}
+
+int main(int argc, char **argv) {
+    std::signal(SIGPIPE, SIG_IGN);
+    LoadGenOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const std::string value{argv[++i]};
+        if (arg == "--unix") options.unixSocketPath = value;
+        else if (arg == "--host") options.host = value;
+        else if (arg == "--port") options.port = static_cast<std::uint16_t>(std::stoul(value));
+        else if (arg == "--connections") options.connections = std::stoul(value);
+        else if (arg == "--requests") options.requests = std::stoul(value);
+        else if (arg == "--op" && (value == "embed" || value == "topk")) {
+            options.op = value == "embed" ? ServerProtocol::Op::Embed : ServerProtocol::Op::TopK;
+        } else if (arg == "--k") options.k = static_cast<std::uint32_t>(std::stoul(value));
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--queries") options.queriesFile = value;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> queries;
+    try {
+        queries = loadQueries(options.queriesFile);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::mutex resultsMutex;
+    std::vector<double> latenciesMs;
+    std::atomic<std::size_t> errors{0};
+    std::atomic<std::size_t> failedConnections{0};
+
+    const clock::time_point t0 = clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < options.connections; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<double> local;
+            local.reserve(options.requests);
+            try {
+                const int fd = connectTo(options);
+                std::string buffer;
+                std::string frame;
+                for (std::size_t r = 0; r < options.requests; ++r) {
+                    ServerProtocol::Request request;
+                    request.op = options.op;
+                    request.id = static_cast<std::uint32_t>(r);
+                    request.k = options.k;
+                    request.filter = options.filter;
+                    request.text = queries[(c + r) % queries.size()];
+                    frame.clear();
+                    ServerProtocol::appendRequest(frame, request);
+
+                    const clock::time_point start = clock::now();
+                    sendAll(fd, frame);
+                    const ServerProtocol::Response response = receiveResponse(fd, buffer);
+                    local.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+
+                    if (response.status != ServerProtocol::Status::Ok || response.id != request.id) ++errors;
+                }
+                ::close(fd);
+            } catch (const std::exception &e) {
+                std::cerr << "Connection " << c << ": " << e.what() << '\n';
+                ++failedConnections;
+            }
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            latenciesMs.insert(latenciesMs.end(), local.begin(), local.end());
+        });
+    }
+    for (std::thread &t: threads) t.join();
+    const double seconds = std::chrono::duration<double>(clock::now() - t0).count();
+
+    std::sort(latenciesMs.begin(), latenciesMs.end());
+    std::cout << "Connections: " << options.connections << " (" << failedConnections.load() << " failed)\n";
+    std::cout << "Requests: " << latenciesMs.size() << " (" << errors.load() << " errors)\n";
+    std::cout << "Elapsed: " << seconds << " s\n";
+    std::cout << "QPS: " << (seconds > 0.0 ? static_cast<double>(latenciesMs.size()) / seconds : 0.0) << '\n';
+    std::cout << "Latency p50: " << percentile(latenciesMs, 0.50) << " ms\n";
+    std::cout << "Latency p99: " << percentile(latenciesMs, 0.99) << " ms\n";
+    std::cout << "Latency max: " << (latenciesMs.empty() ? 0.0 : latenciesMs.back()) << " ms\n";
+    return failedConnections.load() == 0 && errors.load() == 0 ? 0 : 1;
+}
@@ -6,6 +6,10 @@ int main(int argc, char **argv) {
     const std::string chatsFile{"/Users/payedapay/GitHub/VecSimEngineCpp/chats.jsonl"};
     // const int result = TestBgeTokenizerSentencePiece(tokenizerFile, 128, 100);
     // const int result = TestBgeEmbedderONNXRuntime(onnxFile, tokenizerFile, 1000);
+    // const int result = TestEmbedderAutoTuner(onnxFile, tokenizerFile, chatsFile);
+    // const int result = TestSkillFilter();
+    // const int result = TestServerProtocol();
+    // const int result = TestSkillIndexStore();
     const int result = TestVectorSimilarityEngine(tokenizerFile, onnxFile, chatsFile);
 
     return result;
@@ -0,0 +1,129 @@
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include "EmbedderAutoTuner.h"
+#include "VecSimServer.h"
+
+static VecSimServer *g_server = nullptr;
+
+static void onSignal(int signal) {
+    if (!g_server) return;
+    if (signal == SIGHUP) g_server->requestReload();
+    else g_server->stop();
+}
+
+static void printUsage(const char *argv0) {
+    std::cerr << "Usage: " << argv0 << " <tokenizer.model> <model.onnx> <skills.tsv>\n"
+            << "         [--unix PATH | --host HOST --port N [--allow-remote]]\n"
+            << "         [--max-batch N] [--max-delay-us N] [--workers N] [--k N] [--threads N] [--reload-ms N]\n"
+            << "         [--variant NAME:PROVIDER:MODEL]... [--calibration chats.jsonl] [--tuning-cache FILE]\n"
+            << "  <model.onnx> on the default CPU provider is the reference; with --variant the fastest\n"
+            << "  configuration within embedding drift tolerance is picked at startup and cached in\n"
+            << "  <model.onnx>.tuning, or in --tuning-cache FILE (an empty FILE disables caching).\n"
+            << "  The skills file is reloaded when it changes or on SIGHUP, without pausing queries.\n"
+            << "  --host must be a 127.0.0.0/8 address unless --allow-remote is given; requests are not authenticated.\n";
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const std::string tokenizerFile{argv[1]};
+    const std::string onnxFile{argv[2]};
+    const std::string skillsFile{argv[3]};
+
+    VecSimServer::Options options;
+    int threads = 1;
+    std::vector<std::string> variants;
+    std::string calibrationFile;
+    EmbedderAutoTuner::Options tunerOptions;
+    // The choice is recorded for the next start unless the cache is disabled explicitly
+    tunerOptions.cacheFile = onnxFile + ".tuning";
+    for (int i = 4; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg == "--allow-remote") {
+            options.allowNonLoopback = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const std::string value{argv[++i]};
+        if (arg == "--unix") options.unixSocketPath = value;
+        else if (arg == "--host") options.host = value;
+        else if (arg == "--port") options.port = static_cast<std::uint16_t>(std::stoul(value));
+        else if (arg == "--max-batch") options.maxBatch = std::stoul(value);
+        else if (arg == "--max-delay-us") options.maxBatchDelay = std::chrono::microseconds(std::stoul(value));
+        else if (arg == "--workers") options.numWorkers = std::stoul(value);
+        else if (arg == "--k") options.defaultK = std::stoul(value);
+        else if (arg == "--reload-ms") options.reloadCheckInterval = std::chrono::milliseconds(std::stoul(value));
+        else if (arg == "--threads") threads = std::stoi(value);
+        else if (arg == "--variant") variants.push_back(value);
+        else if (arg == "--calibration") calibrationFile = value;
+        else if (arg == "--tuning-cache") tunerOptions.cacheFile = value;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    try {
+        std::vector<BgeEmbedderONNXRuntime::Config> candidates{
+            {"reference", onnxFile, BgeEmbedderONNXRuntime::ExecutionProvider::Cpu, threads, 1}
+        };
+        for (const std::string &variant: variants) {
+            const std::size_t c1 = variant.find(':');
+            const std::size_t c2 = c1 == std::string::npos ? c1 : variant.find(':', c1 + 1);
+            if (c2 == std::string::npos) throw std::invalid_argument("bad --variant, expected NAME:PROVIDER:MODEL: " + variant);
+            candidates.push_back({
+                variant.substr(0, c1),
+                variant.substr(c2 + 1),
+                BgeEmbedderONNXRuntime::parseProvider(variant.substr(c1 + 1, c2 - c1 - 1)),
+                threads,
+                1
+            });
+        }
+
+        BgeEmbedderONNXRuntime::Config embedderConfig = candidates.front();
+        if (candidates.size() > 1) {
+            if (calibrationFile.empty()) throw std::invalid_argument("--variant needs --calibration");
+            const EmbedderAutoTuner tuner(std::make_shared<BgeTokenizerSentencePiece>(tokenizerFile, 512), tunerOptions);
+            std::vector<EmbedderAutoTuner::Result> report;
+            const EmbedderAutoTuner::Result chosen =
+                    tuner.select(candidates, EmbedderAutoTuner::loadCalibrationTexts(calibrationFile), &report);
+            for (const EmbedderAutoTuner::Result &r: report) {
+                std::cout << "  " << r.config.name << " [" << BgeEmbedderONNXRuntime::providerName(r.config.provider)
+                        << "] ";
+                if (!r.error.empty()) std::cout << "skipped: " << r.error << '\n';
+                else std::cout << r.msPerText << " ms/text, drift " << r.maxDrift
+                          << (r.fromCache ? " (cached)" : r.accepted ? "" : " (rejected)") << '\n';
+            }
+            embedderConfig = chosen.config;
+            std::cout << "Using embedder configuration: " << embedderConfig.name << std::endl;
+        }
+
+        const std::shared_ptr<VectorSimilarityEngine> engine =
+                std::make_shared<VectorSimilarityEngine>(tokenizerFile, embedderConfig);
+        VecSimServer server(engine, skillsFile, options);
+
+        g_server = &server;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+        std::signal(SIGHUP, onSignal);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::cout << "Serving " << server.numSkills() << " skills on "
+                << (options.unixSocketPath.empty()
+                        ? options.host + ":" + std::to_string(options.port)
+                        : options.unixSocketPath) << std::endl;
+        server.run();
+        g_server = nullptr;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}